@@ -36,6 +36,8 @@
 #include <QCheckBox>
 #include <QDoubleSpinBox>
 #include <QCursor>
+#include <QMenu>
+#include <QContextMenuEvent>
 
 #include <ThreadWeaver/ThreadWeaver>
 #include <KLocalizedString>
@@ -51,11 +53,14 @@ class FrameGraphicsItem : public QGraphicsRectItem
 {
 public:
     FrameGraphicsItem(const qint64 cost, CostType costType, const QString& function, FrameGraphicsItem* parent = nullptr);
-    FrameGraphicsItem(const qint64 cost, const QString& function, FrameGraphicsItem* parent);
+    FrameGraphicsItem(const qint64 cost, qint32 symbol, const QString& function, FrameGraphicsItem* parent);
 
     qint64 cost() const;
     void setCost(qint64 cost);
     QString function() const;
+    // the string id of the function in the frame table to filter by, or -1 for the root item
+    // and the frames that cannot be filtered, see Frame::isFilterable
+    qint32 symbol() const;
 
     void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
 
@@ -67,6 +72,7 @@ protected:
 
 private:
     qint64 m_cost;
+    qint32 m_symbol = -1;
     QString m_function;
     CostType m_costType;
     bool m_isHovered;
@@ -85,9 +91,10 @@ FrameGraphicsItem::FrameGraphicsItem(const qint64 cost, CostType costType, const
     setAcceptHoverEvents(true);
 }
 
-FrameGraphicsItem::FrameGraphicsItem(const qint64 cost, const QString& function, FrameGraphicsItem* parent)
+FrameGraphicsItem::FrameGraphicsItem(const qint64 cost, qint32 symbol, const QString& function, FrameGraphicsItem* parent)
     : FrameGraphicsItem(cost, parent->m_costType, function, parent)
 {
+    m_symbol = symbol;
 }
 
 qint64 FrameGraphicsItem::cost() const
@@ -105,6 +112,11 @@ QString FrameGraphicsItem::function() const
     return m_function;
 }
 
+qint32 FrameGraphicsItem::symbol() const
+{
+    return m_symbol;
+}
+
 void FrameGraphicsItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* /*widget*/)
 {
     if (isSelected() || m_isHovered) {
@@ -251,35 +263,40 @@ FrameGraphicsItem* findItemByFunction(const QList<QGraphicsItem*>& items, const
 }
 
 /**
- * Convert the top-down graph into a tree of FrameGraphicsItem.
+ * Convert the children of @p node in the top-down graph into a tree of FrameGraphicsItem.
  */
-void toGraphicsItems(const QVector<FrameData>& data, FrameGraphicsItem *parent,
+void toGraphicsItems(const CallTree& data, int node, const FrameTable& frames, FrameGraphicsItem *parent,
                      const double costThreshold, bool collapseRecursion)
 {
-    foreach (const auto& row, data) {
-        if (collapseRecursion && row.symbol == parent->function()) {
+    for (int child = data.firstChild(node); child != CallTree::InvalidNode; child = data.nextSibling(child)) {
+        const auto symbol = frames.symbol(data.frameId(child));
+        if (collapseRecursion && symbol == parent->function()) {
             continue;
         }
-        auto item = findItemByFunction(parent->childItems(), row.symbol);
+        auto item = findItemByFunction(parent->childItems(), symbol);
         if (!item) {
-            item = new FrameGraphicsItem(row.inclusiveCost, row.symbol, parent);
+            const auto frame = frames.frame(data.frameId(child));
+            item = new FrameGraphicsItem(data.inclusiveCost(child), frame.isFilterable() ? frame.symbol : -1,
+                                         symbol, parent);
             item->setPen(parent->pen());
             item->setBrush(hotBrush());
         } else {
-            item->setCost(item->cost() + row.inclusiveCost);
+            item->setCost(item->cost() + data.inclusiveCost(child));
         }
         if (item->cost() > costThreshold) {
-            toGraphicsItems(row.children, item, costThreshold, collapseRecursion);
+            toGraphicsItems(data, child, frames, item, costThreshold, collapseRecursion);
         }
     }
 }
 
-FrameGraphicsItem* parseData(const QVector<FrameData>& topDownData, CostType type,
+FrameGraphicsItem* parseData(const CallTree& topDownData, const FrameTable& frames, CostType type,
                              double costThreshold, bool collapseRecursion)
 {
     double totalCost = 0;
-    foreach(const auto& frame, topDownData) {
-        totalCost += frame.inclusiveCost;
+    for (int node = topDownData.firstChild(CallTree::RootNode); node != CallTree::InvalidNode;
+         node = topDownData.nextSibling(node))
+    {
+        totalCost += topDownData.inclusiveCost(node);
     }
 
     KColorScheme scheme(QPalette::Active);
@@ -294,7 +311,7 @@ FrameGraphicsItem* parseData(const QVector<FrameData>& topDownData, CostType typ
     auto rootItem = new FrameGraphicsItem(totalCost, type, label);
     rootItem->setBrush(scheme.background());
     rootItem->setPen(pen);
-    toGraphicsItems(topDownData, rootItem,
+    toGraphicsItems(topDownData, CallTree::RootNode, frames, rootItem,
                     totalCost * costThreshold / 100., collapseRecursion);
     return rootItem;
 }
@@ -424,22 +441,42 @@ bool FlameGraph::eventFilter(QObject* object, QEvent* event)
         updateTooltip();
     } else if (event->type() == QEvent::Hide) {
         setData(nullptr);
+    } else if (event->type() == QEvent::ContextMenu) {
+        auto contextEvent = static_cast<QContextMenuEvent*>(event);
+        auto item = static_cast<FrameGraphicsItem*>(m_view->itemAt(contextEvent->pos()));
+
+        QMenu menu;
+        if (item && item->symbol() != -1) {
+            const auto symbol = item->symbol();
+            connect(menu.addAction(i18n("Focus on %1", item->function())), &QAction::triggered,
+                    this, [this, symbol] { emit focusSymbolRequested(symbol); });
+            connect(menu.addAction(i18n("Exclude %1", item->function())), &QAction::triggered,
+                    this, [this, symbol] { emit excludeSymbolRequested(symbol); });
+            menu.addSeparator();
+        }
+        menu.addActions(actions());
+        menu.exec(contextEvent->globalPos());
+        return true;
     }
     return ret;
 }
 
-void FlameGraph::setTopDownData(const FrameData& topDownData)
+void FlameGraph::setTopDownData(const Profile& profile)
 {
-    m_topDownData = topDownData;
+    m_profile = profile;
 
-    if (isVisible()) {
+    if (isVisible() && !m_showBottomUpData) {
         showData();
     }
 }
 
-void FlameGraph::setBottomUpData(const FrameData& bottomUpData)
+void FlameGraph::setBottomUpData(const Profile& profile)
 {
-    m_bottomUpData = bottomUpData;
+    m_profile = profile;
+
+    if (isVisible() && m_showBottomUpData) {
+        showData();
+    }
 }
 
 void FlameGraph::showData()
@@ -447,12 +484,15 @@ void FlameGraph::showData()
     setData(nullptr);
 
     using namespace ThreadWeaver;
-    auto data = m_showBottomUpData ? m_bottomUpData.children : m_topDownData.children;
+    // the profile is shared with the job, which only reads it
+    auto profile = m_profile;
+    bool showBottomUpData = m_showBottomUpData;
     bool collapseRecursion = m_collapseRecursion;
     auto source = m_costSource->currentData().value<CostType>();
     auto threshold = m_costThreshold;
-    stream() << make_job([data, source, threshold, collapseRecursion, this]() {
-        auto parsedData = parseData(data, source, threshold, collapseRecursion);
+    stream() << make_job([profile, showBottomUpData, source, threshold, collapseRecursion, this]() {
+        const auto& data = showBottomUpData ? profile.bottomUp() : profile.topDown();
+        auto parsedData = parseData(data, profile.frames(), source, threshold, collapseRecursion);
         QMetaObject::invokeMethod(this, "setData", Qt::QueuedConnection,
                                   Q_ARG(FrameGraphicsItem*, parsedData));
     });
@@ -23,7 +23,7 @@
 #include <QWidget>
 #include <QVector>
 
-#include "models/framedata.h"
+#include "models/profile.h"
 
 class QGraphicsScene;
 class QGraphicsView;
@@ -39,8 +39,18 @@ public:
     FlameGraph(QWidget* parent = nullptr, Qt::WindowFlags flags = 0);
     ~FlameGraph();
 
-    void setTopDownData(const FrameData& topDownData);
-    void setBottomUpData(const FrameData& bottomUpData);
+    void setTopDownData(const Profile& profile);
+    void setBottomUpData(const Profile& profile);
+
+signals:
+    /**
+     * Emitted when the user asks to only show the stacks that contain the @p symbol.
+     */
+    void focusSymbolRequested(qint32 symbol);
+    /**
+     * Emitted when the user asks to hide all stacks that contain the @p symbol.
+     */
+    void excludeSymbolRequested(qint32 symbol);
 
 protected:
     bool eventFilter(QObject* object, QEvent* event) override;
@@ -56,8 +66,7 @@ private:
     void showData();
     void selectItem(FrameGraphicsItem* item);
 
-    FrameData m_topDownData;
-    FrameData m_bottomUpData;
+    Profile m_profile;
 
     QComboBox* m_costSource;
     QGraphicsScene* m_scene;
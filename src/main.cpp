@@ -31,14 +31,12 @@
 
 #include "hotspot-config.h"
 #include "mainwindow.h"
-#include "models/framedata.h"
-#include "models/summarydata.h"
+#include "models/profile.h"
 
 int main(int argc, char** argv)
 {
     QApplication app(argc, argv);
-    qRegisterMetaType<FrameData>();
-    qRegisterMetaType<SummaryData>();
+    qRegisterMetaType<Profile>();
 
     app.setApplicationName(QStringLiteral("hotspot"));
     app.setApplicationVersion(QStringLiteral(HOTSPOT_VERSION_STRING));
@@ -52,12 +50,23 @@ int main(int argc, char** argv)
         QCoreApplication::translate("main", "Optional input files to open on startup, i.e. perf.data files."),
                                  QStringLiteral("[files...]"));
 
+    QCommandLineOption mergeOption(QStringLiteral("merge"),
+        QCoreApplication::translate("main", "Merge all input files into a single aggregated profile, "
+                                            "instead of opening a separate window for each of them."));
+    parser.addOption(mergeOption);
+
     parser.process(app);
 
-    for (const auto& file : parser.positionalArguments()) {
+    if (parser.isSet(mergeOption) && !parser.positionalArguments().isEmpty()) {
         auto window = new MainWindow;
-        window->openFile(file);
+        window->openFiles(parser.positionalArguments());
         window->show();
+    } else {
+        for (const auto& file : parser.positionalArguments()) {
+            auto window = new MainWindow;
+            window->openFile(file);
+            window->show();
+        }
     }
 
     // show at least one mainwindow
@@ -32,10 +32,28 @@
 #include <QFileDialog>
 #include <QSortFilterProxyModel>
 #include <QApplication>
+#include <QActionGroup>
+#include <QMenu>
+#include <QInputDialog>
+#include <QMessageBox>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QDoubleSpinBox>
+#include <QFormLayout>
+#include <QListWidget>
+#include <QMutex>
+#include <QPushButton>
+#include <QVBoxLayout>
 
 #include <KRecursiveFilterProxyModel>
 #include <KStandardAction>
 #include <KLocalizedString>
+#include <KSharedConfig>
+#include <KConfigGroup>
+
+#include <ThreadWeaver/ThreadWeaver>
+
+#include <algorithm>
 
 #include "aboutdialog.h"
 #include "flamegraph.h"
@@ -46,6 +64,10 @@
 #include "models/summarydata.h"
 #include "models/topproxy.h"
 #include "models/callercalleemodel.h"
+#include "models/calledgemodel.h"
+#include "models/profile.h"
+#include "models/foldingrule.h"
+#include "models/sourcecodemodel.h"
 
 namespace {
 QString formatTimeString(quint64 nanoseconds)
@@ -67,6 +89,36 @@ QString formatTimeString(quint64 nanoseconds)
             + format(seconds) + QLatin1Char('.') + format(milliseconds, 3) + QLatin1Char('s');
 }
 
+// the folding rules are saved per project, i.e. for the directory of the profile data
+QString projectKey(const QStringList& paths)
+{
+    return QFileInfo(paths.first()).absolutePath();
+}
+
+QVector<FoldingRule> loadFoldingRules(const QString& project)
+{
+    KConfigGroup group(KSharedConfig::openConfig(), "FoldingRules");
+    QVector<FoldingRule> rules;
+    for (const auto& text : group.readEntry(project, QStringList())) {
+        FoldingRule rule;
+        if (FoldingRule::fromString(text, &rule)) {
+            rules.append(rule);
+        }
+    }
+    return rules;
+}
+
+void saveFoldingRules(const QString& project, const QVector<FoldingRule>& rules)
+{
+    QStringList texts;
+    for (const auto& rule : rules) {
+        texts.append(rule.toString());
+    }
+    KConfigGroup group(KSharedConfig::openConfig(), "FoldingRules");
+    group.writeEntry(project, texts);
+    group.sync();
+}
+
 void setupTreeView(QTreeView* view, KFilterProxySearchLine* filter,
                    CostModel* model)
 {
@@ -82,11 +134,20 @@ void setupTreeView(QTreeView* view, KFilterProxySearchLine* filter,
 }
 }
 
+struct MainWindow::FilterTarget
+{
+    QMutex mutex;
+    // reset when the window gets destroyed, the jobs only post to it while locked
+    MainWindow* window = nullptr;
+};
+
 MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent),
     ui(new Ui::MainWindow),
-    m_parser(new PerfParser(this))
+    m_parser(new PerfParser(this)),
+    m_filterTarget(std::make_shared<FilterTarget>())
 {
+    m_filterTarget->window = this;
     ui->setupUi(this);
 
     ui->lostMessage->setVisible(false);
@@ -99,77 +160,210 @@ MainWindow::MainWindow(QWidget *parent) :
             this, &MainWindow::aboutKDAB);
     connect(ui->actionAbout_Hotspot, &QAction::triggered,
             this, &MainWindow::aboutHotspot);
+    connect(ui->actionCollapse_Kernel_Frames, &QAction::toggled,
+            this, [this] (bool collapse) {
+                m_parser->setCollapseKernelFrames(collapse);
+                reload();
+            });
+    connect(ui->actionGroup_By_Process, &QAction::toggled,
+            this, [this] (bool group) {
+                m_parser->setGroupByProcess(group);
+                reload();
+            });
+    connect(ui->actionFold_Recursion, &QAction::toggled,
+            this, [this] (bool fold) {
+                m_parser->setFoldRecursion(fold);
+                reload();
+            });
+
+    auto aggregationGroup = new QActionGroup(this);
+    const std::initializer_list<QPair<QAction*, PerfParser::Aggregation>> aggregationActions = {
+        {ui->actionAggregate_By_Address, PerfParser::Aggregation::Address},
+        {ui->actionAggregate_By_Source_Line, PerfParser::Aggregation::SourceLine},
+        {ui->actionAggregate_By_Function, PerfParser::Aggregation::Function},
+        {ui->actionAggregate_By_Binary, PerfParser::Aggregation::Binary}
+    };
+    for (const auto& aggregationAction : aggregationActions) {
+        auto action = aggregationAction.first;
+        const auto aggregation = aggregationAction.second;
+        aggregationGroup->addAction(action);
+        action->setChecked(m_parser->aggregation() == aggregation);
+        connect(action, &QAction::triggered,
+                this, [this, aggregation] () {
+                    if (m_parser->aggregation() != aggregation) {
+                        m_parser->setAggregation(aggregation);
+                        reload();
+                    }
+                });
+    }
 
     ui->mainPageStack->setCurrentWidget(ui->startPage);
     ui->openFileButton->setFocus();
 
     auto bottomUpCostModel = new CostModel(this);
+    m_bottomUpCostModel = bottomUpCostModel;
     setupTreeView(ui->bottomUpTreeView,  ui->bottomUpSearch,
                   bottomUpCostModel);
     // only the top rows have a self cost == inclusive cost in the bottom up view
     ui->bottomUpTreeView->hideColumn(CostModel::SelfCost);
 
     auto topDownCostModel = new CostModel(this);
+    m_topDownCostModel = topDownCostModel;
     setupTreeView(ui->topDownTreeView, ui->topDownSearch,
                   topDownCostModel);
 
+    // the source files are only mapped once they get opened
+    m_sourceModel = new SourceCodeModel(this);
+    ui->sourceView->setModel(m_sourceModel);
+
     auto topHotspotsProxy = new TopProxy(this);
     topHotspotsProxy->setSourceModel(bottomUpCostModel);
 
     ui->topHotspotsTableView->setSortingEnabled(false);
     ui->topHotspotsTableView->setModel(topHotspotsProxy);
 
+    for (QAbstractItemView* view : {static_cast<QAbstractItemView*>(ui->bottomUpTreeView),
+                                    static_cast<QAbstractItemView*>(ui->topDownTreeView),
+                                    static_cast<QAbstractItemView*>(ui->topHotspotsTableView)})
+    {
+        view->setContextMenuPolicy(Qt::CustomContextMenu);
+        connect(view, &QWidget::customContextMenuRequested,
+                this, [this, view] (const QPoint& pos) {
+                    showFilterMenu(view, pos);
+                });
+    }
+    connect(ui->flameGraph, &FlameGraph::focusSymbolRequested,
+            this, &MainWindow::focusSymbol);
+    connect(ui->flameGraph, &FlameGraph::excludeSymbolRequested,
+            this, &MainWindow::excludeSymbol);
+    connect(ui->actionClear_Filter, &QAction::triggered,
+            this, &MainWindow::clearFilter);
+    connect(ui->actionEdit_Folding_Rules, &QAction::triggered,
+            this, &MainWindow::editFoldingRules);
+    connect(ui->actionFilter_Time_Range, &QAction::triggered,
+            this, &MainWindow::filterTimeRange);
+    connect(ui->actionSelect_Threads, &QAction::triggered,
+            this, &MainWindow::selectThreads);
+
     auto callerCalleeCostModel = new CallerCalleeModel(this);
     auto proxy = new QSortFilterProxyModel(this);
     proxy->setSourceModel(callerCalleeCostModel);
     ui->callerCalleeTableView->setSortingEnabled(true);
     ui->callerCalleeTableView->setModel(proxy);
 
+    auto callersModel = new CallEdgeModel(CallEdgeModel::Callers, this);
+    auto callersProxy = new QSortFilterProxyModel(this);
+    callersProxy->setSourceModel(callersModel);
+    ui->callersView->setModel(callersProxy);
+    ui->callersView->sortByColumn(CallEdgeModel::InclusiveCost);
+
+    auto calleesModel = new CallEdgeModel(CallEdgeModel::Callees, this);
+    auto calleesProxy = new QSortFilterProxyModel(this);
+    calleesProxy->setSourceModel(calleesModel);
+    ui->calleesView->setModel(calleesProxy);
+    ui->calleesView->sortByColumn(CallEdgeModel::InclusiveCost);
+
+    connect(ui->callerCalleeTableView->selectionModel(), &QItemSelectionModel::currentRowChanged,
+            this, [callersModel, calleesModel] (const QModelIndex& current) {
+                const auto function = current.isValid()
+                    ? current.data(CallerCalleeModel::FunctionRole).toInt()
+                    : int(CallTree::InvalidNode);
+                callersModel->setFunction(function);
+                calleesModel->setFunction(function);
+            });
+
     setStyleSheet(QStringLiteral("QMainWindow { background: url(:/images/kdabproducts.png) top right no-repeat; }"));
 
     connect(m_parser, &PerfParser::bottomUpDataAvailable,
-            this, [this, bottomUpCostModel] (const FrameData& data) {
-                bottomUpCostModel->setData(data);
-                ui->flameGraph->setBottomUpData(data);
+            this, [this, bottomUpCostModel] (const Profile& profile) {
+                m_profile = profile;
+                if (!m_filter.isEmpty()) {
+                    applyFilter();
+                    return;
+                }
+                bottomUpCostModel->setData(profile.bottomUp(), profile.frames());
+                ui->flameGraph->setBottomUpData(profile);
             });
 
     connect(m_parser, &PerfParser::topDownDataAvailable,
-            this, [this, topDownCostModel] (const FrameData& data) {
-                topDownCostModel->setData(data);
-                ui->flameGraph->setTopDownData(data);
+            this, [this, topDownCostModel] (const Profile& profile) {
+                m_profile = profile;
+                if (!m_filter.isEmpty()) {
+                    applyFilter();
+                    return;
+                }
+                topDownCostModel->setData(profile.topDown(), profile.frames());
+                ui->flameGraph->setTopDownData(profile);
             });
 
     connect(m_parser, &PerfParser::summaryDataAvailable,
-            this, [this] (const SummaryData& data) {
+            this, [this] (const Profile& profile) {
+                // filters are not kept across parse operations
+                m_profile = profile;
+                m_filter = {};
+                ++m_filterGeneration;
+                ui->actionClear_Filter->setEnabled(false);
+                ui->actionFilter_Time_Range->setEnabled(true);
+                ui->actionSelect_Threads->setEnabled(true);
+
+                const auto& data = profile.summary();
                 ui->appRunTimeValue->setText(formatTimeString(data.applicationRunningTime));
                 ui->threadCountValue->setText(QString::number(data.threadCount));
                 ui->processCountValue->setText(QString::number(data.processCount));
                 ui->sampleCountValue->setText(QString::number(data.sampleCount));
                 ui->commandValue->setText(data.command);
-                ui->lostChunksValue->setText(QString::number(data.lostChunks));
-                if (data.lostChunks > 0) {
-                    ui->lostMessage->setText(i18np("Lost one chunk - Check IO/CPU overload!",
-                                                   "Lost %1 chunks - Check IO/CPU overload!",
-                                                   data.lostChunks));
-                    ui->lostMessage->setVisible(true);
-                } else {
-                    ui->lostMessage->setVisible(false);
+                showLostChunks();
+                QStringList lostIntervals;
+                for (const auto& interval : data.lostIntervals) {
+                    auto relativeTime = [&data] (quint64 time) {
+                        return formatTimeString(time > data.applicationStartTime ? time - data.applicationStartTime : 0);
+                    };
+                    lostIntervals.append(i18np("%2 - %3 (one chunk)", "%2 - %3 (%1 chunks)", interval.chunks,
+                                               relativeTime(interval.startTime),
+                                               relativeTime(interval.endTime)));
+                }
+                ui->lostIntervalsValue->setText(lostIntervals.join(QLatin1Char('\n')));
+                ui->lostIntervalsLabel->setVisible(!lostIntervals.isEmpty());
+                ui->lostIntervalsValue->setVisible(!lostIntervals.isEmpty());
+                ui->foldingRulesValue->setText(data.foldingRules.join(QLatin1Char('\n')));
+                ui->foldingRulesLabel->setVisible(!data.foldingRules.isEmpty());
+                ui->foldingRulesValue->setVisible(!data.foldingRules.isEmpty());
+
+                // the line costs of the previously shown source file are outdated
+                m_sourceModel->setSource({}, {});
+                ui->sourceFileLabel->setText(tr("Open the source of a function from the context menu of the tree views."));
+
+                // the binary costs are known before any of the trees are built
+                auto binaryCosts = ui->binaryCostsTableWidget;
+                binaryCosts->setRowCount(data.binaryCosts.size());
+                auto costText = [&data](quint64 cost) {
+                    return QStringLiteral("%1 (%2%)").arg(cost)
+                        .arg(data.sampleCount ? 100. * cost / data.sampleCount : 0., 0, 'f', 1);
+                };
+                for (int row = 0; row < data.binaryCosts.size(); ++row) {
+                    const auto& cost = data.binaryCosts.at(row);
+                    const auto binary = cost.binary.isEmpty() ? QStringLiteral("??") : cost.binary;
+                    binaryCosts->setItem(row, 0, new QTableWidgetItem(binary));
+                    binaryCosts->setItem(row, 1, new QTableWidgetItem(costText(cost.selfCost)));
+                    binaryCosts->setItem(row, 2, new QTableWidgetItem(costText(cost.inclusiveCost)));
                 }
+                // the summary is ready before the trees, which get filled in once they are built
+                ui->mainPageStack->setCurrentWidget(ui->resultsPage);
+                ui->resultsTabWidget->setCurrentWidget(ui->summaryTab);
+                ui->resultsTabWidget->setFocus();
             });
 
     connect(m_parser, &PerfParser::callerCalleeDataAvailable,
-            this, [this, callerCalleeCostModel] (const FrameData& data) {
-                callerCalleeCostModel->setData(data);
+            this, [this, callerCalleeCostModel, callersModel, calleesModel]
+                  (const Profile& profile) {
+                m_profile = profile;
+                const auto& data = profile.callerCallee();
+                callerCalleeCostModel->setData(data, profile.frames());
+                callersModel->setData(data, profile.callGraph(), profile.frames());
+                calleesModel->setData(data, profile.callGraph(), profile.frames());
                 ui->callerCalleeTableView->sortByColumn(CallerCalleeModel::InclusiveCost);
             });
 
-    connect(m_parser, &PerfParser::parsingFinished,
-            this, [this] () {
-                ui->mainPageStack->setCurrentWidget(ui->resultsPage);
-                ui->resultsTabWidget->setCurrentWidget(ui->summaryTab);
-                ui->resultsTabWidget->setFocus();
-            });
-
     connect(m_parser, &PerfParser::parsingFailed,
             this, [this] (const QString& errorMessage) {
                 qWarning() << errorMessage;
@@ -185,32 +379,313 @@ MainWindow::MainWindow(QWidget *parent) :
     clear();
 }
 
-MainWindow::~MainWindow() = default;
+MainWindow::~MainWindow()
+{
+    m_parser->stop();
+    // the results of the filter jobs that are still running get dropped
+    QMutexLocker lock(&m_filterTarget->mutex);
+    m_filterTarget->window = nullptr;
+}
 
 void MainWindow::on_openFileButton_clicked()
 {
-    const auto fileName = QFileDialog::getOpenFileName(this, tr("Open File"), QDir::homePath(), tr("Data Files (*.data)"));
+    // selecting multiple files merges them into a single profile
+    const auto fileNames = QFileDialog::getOpenFileNames(this, tr("Open File"), QDir::homePath(), tr("Data Files (*.data)"));
+    if (fileNames.isEmpty()) {
+        return;
+    }
 
-    openFile(fileName);
+    openFiles(fileNames);
+}
+
+void MainWindow::setFilteredProfile(const Profile& profile, int filterGeneration)
+{
+    if (filterGeneration != m_filterGeneration) {
+        // the filter changed while this profile was built
+        return;
+    }
+
+    m_bottomUpCostModel->setData(profile.bottomUp(), profile.frames());
+    m_topDownCostModel->setData(profile.topDown(), profile.frames());
+    ui->flameGraph->setBottomUpData(profile);
+    ui->flameGraph->setTopDownData(profile);
+}
+
+void MainWindow::focusSymbol(qint32 symbol)
+{
+    m_filter.focusedSymbols.append(symbol);
+    applyFilter();
+}
+
+void MainWindow::excludeSymbol(qint32 symbol)
+{
+    m_filter.excludedSymbols.append(symbol);
+    applyFilter();
+}
+
+void MainWindow::filterTimeRange()
+{
+    // the range is entered in seconds relative to the first sample
+    const auto& summary = m_profile.summary();
+    const double runningTime = summary.applicationRunningTime / 1E9;
+    auto relativeTime = [&summary](quint64 time) {
+        return time > summary.applicationStartTime ? (time - summary.applicationStartTime) / 1E9 : 0.;
+    };
+
+    QDialog dialog(this);
+    dialog.setWindowTitle(tr("Filter Time Range"));
+    auto layout = new QFormLayout(&dialog);
+    auto startTime = new QDoubleSpinBox(&dialog);
+    auto endTime = new QDoubleSpinBox(&dialog);
+    for (auto spinBox : {startTime, endTime}) {
+        spinBox->setDecimals(3);
+        spinBox->setRange(0, runningTime);
+        spinBox->setSuffix(tr("s"));
+    }
+    startTime->setValue(m_filter.hasTimeRange() ? relativeTime(m_filter.startTime) : 0);
+    endTime->setValue(m_filter.hasTimeRange() ? relativeTime(m_filter.endTime) : runningTime);
+    layout->addRow(tr("Start:"), startTime);
+    layout->addRow(tr("End:"), endTime);
+    auto buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    layout->addRow(buttons);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    const auto start = std::min(startTime->value(), endTime->value());
+    const auto end = std::max(startTime->value(), endTime->value());
+    m_filter.startTime = summary.applicationStartTime + quint64(start * 1E9);
+    m_filter.endTime = summary.applicationStartTime + quint64(end * 1E9);
+    applyFilter();
+}
+
+void MainWindow::selectThreads()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle(tr("Select Threads"));
+    auto layout = new QVBoxLayout(&dialog);
+    auto list = new QListWidget(&dialog);
+    const auto& threads = m_profile.threads();
+    for (int thread = 0; thread < threads.size(); ++thread) {
+        auto item = new QListWidgetItem(i18np("%2 (%3, one sample)", "%2 (%3, %1 samples)",
+                                              threads.sampleCount(thread), threads.name(thread),
+                                              threads.tid(thread)), list);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        const bool selected = m_filter.threads.isEmpty() || m_filter.threads.contains(thread);
+        item->setCheckState(selected ? Qt::Checked : Qt::Unchecked);
+    }
+    layout->addWidget(list);
+    auto buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    // an empty selection would be taken for all threads, so at least one has to be checked
+    auto updateOkButton = [list, buttons]() {
+        bool anyChecked = false;
+        for (int thread = 0; thread < list->count() && !anyChecked; ++thread) {
+            anyChecked = list->item(thread)->checkState() == Qt::Checked;
+        }
+        buttons->button(QDialogButtonBox::Ok)->setEnabled(anyChecked);
+    };
+    connect(list, &QListWidget::itemChanged, &dialog, updateOkButton);
+    updateOkButton();
+    layout->addWidget(buttons);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    QVector<int> selectedThreads;
+    for (int thread = 0; thread < list->count(); ++thread) {
+        if (list->item(thread)->checkState() == Qt::Checked) {
+            selectedThreads.append(thread);
+        }
+    }
+    // selecting all threads is the same as not filtering by thread
+    if (selectedThreads.size() == threads.size()) {
+        selectedThreads.clear();
+    }
+    m_filter.threads = selectedThreads;
+    applyFilter();
+}
+
+void MainWindow::clearFilter()
+{
+    m_filter = {};
+    applyFilter();
+}
+
+void MainWindow::applyFilter()
+{
+    ui->actionClear_Filter->setEnabled(!m_filter.isEmpty());
+    showLostChunks();
+
+    const auto filterGeneration = ++m_filterGeneration;
+    const auto profile = m_profile;
+    const auto filter = m_filter;
+    using namespace ThreadWeaver;
+    stream() << make_job([profile, filter, filterGeneration, target = m_filterTarget]() {
+        // the trees of the stacks that pass the filter are built from the symbol index of the profile
+        const auto filteredProfile = filter.isEmpty() ? profile : profile.filtered(filter);
+        // the posted result gets discarded when the window is destroyed before it arrives
+        QMutexLocker lock(&target->mutex);
+        if (target->window) {
+            QMetaObject::invokeMethod(target->window, "setFilteredProfile", Qt::QueuedConnection,
+                                      Q_ARG(Profile, filteredProfile), Q_ARG(int, filterGeneration));
+        }
+    });
+}
+
+void MainWindow::showLostChunks()
+{
+    const auto& data = m_profile.summary();
+    if (!m_filter.hasTimeRange()) {
+        ui->lostChunksValue->setText(QString::number(data.lostChunks));
+        ui->lostMessage->setText(i18np("Lost one chunk - Check IO/CPU overload!",
+                                       "Lost %1 chunks - Check IO/CPU overload!",
+                                       data.lostChunks));
+        ui->lostMessage->setVisible(data.lostChunks > 0);
+        return;
+    }
+
+    // the samples of the selected time range are unreliable when chunks got lost in it
+    const auto lostChunks = data.lostChunksInRange(m_filter.startTime, m_filter.endTime);
+    ui->lostChunksValue->setText(i18n("%1 (%2 in the selected time range)", data.lostChunks, lostChunks));
+    ui->lostMessage->setText(i18np("Lost one chunk in the selected time range - Check IO/CPU overload!",
+                                   "Lost %1 chunks in the selected time range - Check IO/CPU overload!",
+                                   lostChunks));
+    ui->lostMessage->setVisible(lostChunks > 0);
+}
+
+void MainWindow::showFilterMenu(QAbstractItemView* view, const QPoint& pos)
+{
+    QMenu menu;
+    const auto index = view->indexAt(pos);
+    if (index.isValid()) {
+        const auto frame = m_profile.frames().frame(index.data(CostModel::FrameRole).toInt());
+        const auto function = index.sibling(index.row(), CostModel::Symbol).data().toString();
+        // like in the flame graph
+        if (frame.isFilterable()) {
+            const auto symbol = frame.symbol;
+            connect(menu.addAction(i18n("Focus on %1", function)), &QAction::triggered,
+                    this, [this, symbol] { focusSymbol(symbol); });
+            connect(menu.addAction(i18n("Exclude %1", function)), &QAction::triggered,
+                    this, [this, symbol] { excludeSymbol(symbol); });
+        }
+        // the file of a process frame is the input it was recorded in
+        if (!frame.isProcess && frame.file != -1) {
+            connect(menu.addAction(i18n("Show Source of %1", function)), &QAction::triggered,
+                    this, [this, frame] { showSource(frame); });
+        }
+    }
+    menu.addAction(ui->actionClear_Filter);
+    menu.exec(view->viewport()->mapToGlobal(pos));
+}
+
+void MainWindow::showSource(const Frame& frame)
+{
+    const auto file = m_profile.frames().string(frame.file);
+    const auto lineCosts = m_profile.sourceCosts().lineCosts(file);
+    if (m_sourceModel->setSource(file, lineCosts)) {
+        ui->sourceFileLabel->setText(file);
+        auto line = frame.line;
+        if (line == -1 && !lineCosts.isEmpty()) {
+            // aggregated functions have no line, show the hottest one of their file
+            line = std::max_element(lineCosts.begin(), lineCosts.end(), [](const LineCost& lhs, const LineCost& rhs) {
+                return lhs.selfCost < rhs.selfCost;
+            })->line;
+        }
+        const auto index = m_sourceModel->index(m_sourceModel->rowForLine(line), 0);
+        ui->sourceView->setCurrentIndex(index);
+        ui->sourceView->scrollTo(index, QAbstractItemView::PositionAtCenter);
+    } else {
+        ui->sourceFileLabel->setText(tr("Failed to open the source file %1.").arg(file));
+    }
+    ui->resultsTabWidget->setCurrentWidget(ui->sourceTab);
+}
+
+void MainWindow::editFoldingRules()
+{
+    QStringList texts;
+    for (const auto& rule : m_parser->foldingRules()) {
+        texts.append(rule.toString());
+    }
+
+    bool ok = false;
+    const auto text = QInputDialog::getMultiLineText(this, tr("Edit Folding Rules"),
+        tr("One rule per line, either \"collapse symbol|binary <pattern>\" to collapse matching frames "
+           "into their caller, or \"merge symbol|binary <pattern> -> <name>\" to merge them into a frame "
+           "with the given name:"),
+        texts.join(QLatin1Char('\n')), &ok);
+    if (!ok) {
+        return;
+    }
+
+    QVector<FoldingRule> rules;
+    QStringList invalidRules;
+    for (const auto& line : text.split(QLatin1Char('\n'), QString::SkipEmptyParts)) {
+        FoldingRule rule;
+        if (FoldingRule::fromString(line, &rule)) {
+            rules.append(rule);
+        } else if (!line.trimmed().isEmpty()) {
+            invalidRules.append(line);
+        }
+    }
+    if (!invalidRules.isEmpty()) {
+        QMessageBox::warning(this, tr("Invalid Folding Rules"),
+                             tr("The following rules are invalid and were ignored:\n%1")
+                                .arg(invalidRules.join(QLatin1Char('\n'))));
+    }
+
+    saveFoldingRules(projectKey(m_paths), rules);
+    m_parser->setFoldingRules(rules);
+    reload();
 }
 
 void MainWindow::clear()
 {
+    // the results of a running parse operation would show up again
+    m_parser->stop();
     setWindowTitle(tr("Hotspot"));
+    m_paths.clear();
+    ui->actionEdit_Folding_Rules->setEnabled(false);
+    ui->actionFilter_Time_Range->setEnabled(false);
+    ui->actionSelect_Threads->setEnabled(false);
     ui->loadingResultsErrorLabel->hide();
     ui->mainPageStack->setCurrentWidget(ui->startPage);
     ui->loadStack->setCurrentWidget(ui->openFilePage);
 }
 
+void MainWindow::reload()
+{
+    if (!m_paths.isEmpty()) {
+        openFiles(m_paths);
+    }
+}
+
 void MainWindow::openFile(const QString& path)
 {
-    setWindowTitle(tr("%1 - Hotspot").arg(QFileInfo(path).fileName()));
+    openFiles({path});
+}
+
+void MainWindow::openFiles(const QStringList& paths)
+{
+    m_paths = paths;
+
+    if (paths.size() == 1) {
+        setWindowTitle(tr("%1 - Hotspot").arg(QFileInfo(paths.first()).fileName()));
+    } else {
+        setWindowTitle(tr("%1 merged files - Hotspot").arg(paths.size()));
+    }
+
+    m_parser->setFoldingRules(loadFoldingRules(projectKey(paths)));
+    ui->actionEdit_Folding_Rules->setEnabled(true);
 
     ui->loadingResultsErrorLabel->hide();
     ui->loadStack->setCurrentWidget(ui->parseProgressPage);
 
     // TODO: support input files of different types via plugins
-    m_parser->startParseFile(path);
+    m_parser->startParseFiles(paths);
 }
 
 void MainWindow::aboutKDAB()
@@ -30,15 +30,22 @@
 #include <QMainWindow>
 #include <QScopedPointer>
 #include <QString>
+#include <QStringList>
 
-#include "models/framedata.h"
+#include <memory>
+
+#include "models/profile.h"
 
 namespace Ui {
 class MainWindow;
 }
 
+class QAbstractItemView;
+class QPoint;
+
 class CostModel;
 class PerfParser;
+class SourceCodeModel;
 
 class MainWindow : public QMainWindow
 {
@@ -51,14 +58,50 @@ public:
 public slots:
     void clear();
     void openFile(const QString& path);
+    void openFiles(const QStringList& paths);
+    void reload();
 
     void aboutKDAB();
     void aboutHotspot();
 
 private slots:
     void on_openFileButton_clicked();
+    void setFilteredProfile(const Profile& profile, int filterGeneration);
 
 private:
+    void focusSymbol(qint32 symbol);
+    void excludeSymbol(qint32 symbol);
+    void filterTimeRange();
+    void selectThreads();
+    void clearFilter();
+    void editFoldingRules();
+    /**
+     * Show the source file of the @p frame in the source tab, scrolled to its line.
+     */
+    void showSource(const Frame& frame);
+    /**
+     * Rebuild the trees of the profile with the current filter in a background job.
+     */
+    void applyFilter();
+    /**
+     * Show the lost chunks of the profile, or of the time range of the filter when it has one.
+     */
+    void showLostChunks();
+    void showFilterMenu(QAbstractItemView* view, const QPoint& pos);
+
+    // the window that the filter jobs deliver their results to, while it exists
+    struct FilterTarget;
+
     Ui::MainWindow *ui;
     PerfParser* m_parser;
+    QStringList m_paths;
+    CostModel* m_bottomUpCostModel = nullptr;
+    CostModel* m_topDownCostModel = nullptr;
+    SourceCodeModel* m_sourceModel = nullptr;
+    // the latest published profile, before filtering
+    Profile m_profile;
+    StackFilter m_filter;
+    // incremented whenever the filter changes, to discard outdated results
+    int m_filterGeneration = 0;
+    std::shared_ptr<FilterTarget> m_filterTarget;
 };
@@ -0,0 +1,126 @@
+/*
+  calledgemodel.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "calledgemodel.h"
+
+CallEdgeModel::CallEdgeModel(Direction direction, QObject* parent)
+    : QAbstractTableModel(parent)
+    , m_direction(direction)
+{
+}
+
+CallEdgeModel::~CallEdgeModel() = default;
+
+int CallEdgeModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : NUM_COLUMNS;
+}
+
+int CallEdgeModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_direction == Callers ? m_graph.callerCount(m_function) : m_graph.calleeCount(m_function);
+}
+
+QVariant CallEdgeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role == Qt::InitialSortOrderRole) {
+        if (section == SelfCost || section == InclusiveCost) {
+            return Qt::DescendingOrder;
+        }
+    }
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return {};
+    }
+
+    switch (static_cast<Columns>(section)) {
+        case Symbol:
+            return m_direction == Callers ? tr("Caller") : tr("Callee");
+        case Binary:
+            return tr("Binary");
+        case SelfCost:
+            return tr("Self Cost");
+        case InclusiveCost:
+            return tr("Inclusive Cost");
+        case NUM_COLUMNS:
+            // fall-through
+            break;
+    }
+
+    return {};
+}
+
+QVariant CallEdgeModel::data(const QModelIndex& index, int role) const
+{
+    if (!hasIndex(index.row(), index.column(), index.parent()) || role != Qt::DisplayRole) {
+        return {};
+    }
+
+    const auto& edge = this->edge(index.row());
+    const auto function = m_direction == Callers ? edge.caller : edge.callee;
+    const auto frameId = m_functions.frameId(function);
+
+    switch (static_cast<Columns>(index.column())) {
+        case Symbol:
+            return m_frames.symbol(frameId);
+        case Binary:
+            return m_frames.binary(frameId);
+        case SelfCost:
+            return edge.selfCost;
+        case InclusiveCost:
+            return edge.inclusiveCost;
+        case NUM_COLUMNS:
+            // do nothing
+            break;
+    }
+
+    return {};
+}
+
+void CallEdgeModel::setData(const CallTree& functions, const CallGraph& graph, const FrameTable& frames)
+{
+    beginResetModel();
+    m_functions = functions;
+    m_graph = graph;
+    m_frames = frames;
+    m_function = CallTree::InvalidNode;
+    endResetModel();
+}
+
+void CallEdgeModel::setFunction(int function)
+{
+    beginResetModel();
+    m_function = function;
+    endResetModel();
+}
+
+const CallEdge& CallEdgeModel::edge(int row) const
+{
+    return m_direction == Callers ? m_graph.caller(m_function, row) : m_graph.callee(m_function, row);
+}
@@ -0,0 +1,84 @@
+/*
+  calledgemodel.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QAbstractItemModel>
+
+#include "callgraph.h"
+#include "calltree.h"
+#include "frametable.h"
+
+/**
+ * Lists the callers or the callees of a single function of the caller-callee data.
+ */
+class CallEdgeModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Direction {
+        Callers,
+        Callees
+    };
+
+    explicit CallEdgeModel(Direction direction, QObject* parent = nullptr);
+    ~CallEdgeModel();
+
+    enum Columns {
+        Symbol = 0,
+        Binary,
+        SelfCost,
+        InclusiveCost,
+        NUM_COLUMNS
+    };
+
+    int columnCount(const QModelIndex& parent = {}) const override;
+    int rowCount(const QModelIndex &parent = {}) const override;
+
+    QVariant headerData(int section, Qt::Orientation orientation = Qt::Horizontal,
+                        int role = Qt::DisplayRole) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    using QAbstractTableModel::setData;
+    /**
+     * @p functions are the caller-callee data whose nodes are referenced by @p graph.
+     */
+    void setData(const CallTree& functions, const CallGraph& graph, const FrameTable& frames);
+    /**
+     * Show the edges of @p function, a node of the caller-callee data.
+     */
+    void setFunction(int function);
+
+private:
+    const CallEdge& edge(int row) const;
+
+    Direction m_direction;
+    CallTree m_functions;
+    CallGraph m_graph;
+    FrameTable m_frames;
+    int m_function = CallTree::InvalidNode;
+};
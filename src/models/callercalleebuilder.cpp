@@ -0,0 +1,165 @@
+/*
+  callercalleebuilder.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "callercalleebuilder.h"
+
+#include <algorithm>
+
+#include <util.h>
+
+#include "stacktable.h"
+
+bool operator==(const CallerCalleeLocation& lhs, const CallerCalleeLocation& rhs)
+{
+    return lhs.symbol == rhs.symbol && lhs.binary == rhs.binary;
+}
+
+uint qHash(const CallerCalleeLocation& location, uint seed)
+{
+    Util::HashCombine hash;
+    seed = hash(seed, location.symbol);
+    seed = hash(seed, location.binary);
+    return seed;
+}
+
+CallerCalleeBuilder::CallerCalleeBuilder(const FrameTable& frameTable)
+    : m_frameTable(frameTable)
+{
+}
+
+CallerCalleeLocation CallerCalleeBuilder::location(qint32 frameId) const
+{
+    const auto frame = m_frameTable.frame(frameId);
+    return {frame.symbol, frame.binary};
+}
+
+int CallerCalleeBuilder::entry(qint32 frameId)
+{
+    const auto cachedFrames = m_frameEntries.size();
+    if (cachedFrames <= frameId) {
+        m_frameEntries.resize(m_frameTable.frameCount());
+        std::fill(m_frameEntries.begin() + cachedFrames, m_frameEntries.end(), int(CallTree::InvalidNode));
+    }
+
+    auto& entry = m_frameEntries[frameId];
+    if (entry == CallTree::InvalidNode) {
+        const auto location = this->location(frameId);
+        auto it = m_entries.find(location);
+        if (it == m_entries.end()) {
+            // the entry is displayed with the location of the first frame of its symbol
+            it = m_entries.insert(location, m_result.addChild(CallTree::RootNode, frameId));
+            m_epochs.resize(m_result.size());
+        }
+        entry = it.value();
+    }
+    return entry;
+}
+
+void CallerCalleeBuilder::addStack(const StackTable& stacks, int stack)
+{
+    const auto count = stacks.count(stack);
+    // we must not count symbols more than once per stack in the caller-callee data,
+    // so every entry gets stamped with the epoch of the last stack that added to it
+    ++m_epoch;
+    int callee = CallTree::InvalidNode;
+    bool isInnermostCall = true;
+    for (int i = 0, c = stacks.frameCount(stack); i < c; ++i) {
+        const auto entry = this->entry(stacks.frameId(stack, i));
+        const bool isInnermost = callee == CallTree::InvalidNode;
+        if (!isInnermost) {
+            // only the innermost call contributes to the self cost of its callee
+            addEdge(entry, callee, count, isInnermostCall ? count : 0);
+            isInnermostCall = false;
+        }
+        callee = entry;
+
+        if (m_epochs.at(entry) == m_epoch) {
+            continue;
+        }
+        m_epochs[entry] = m_epoch;
+
+        m_result.addCost(entry, count, stacks.kernelCost(stack));
+        if (isInnermost) {
+            m_result.addSelfCost(entry, count);
+        }
+    }
+}
+
+int CallerCalleeBuilder::edge(int caller, int callee)
+{
+    const auto key = qMakePair(caller, callee);
+    auto it = m_edgeIds.find(key);
+    if (it == m_edgeIds.end()) {
+        it = m_edgeIds.insert(key, m_edges.size());
+        m_edges.append({caller, callee, 0, 0});
+        m_edgeEpochs.append(0);
+    }
+    return it.value();
+}
+
+void CallerCalleeBuilder::addEdge(int caller, int callee, quint32 cost, quint32 selfCost)
+{
+    // like the functions, recursive calls must only be counted once per stack
+    const auto edgeId = edge(caller, callee);
+    if (m_edgeEpochs.at(edgeId) == m_epoch) {
+        return;
+    }
+    m_edgeEpochs[edgeId] = m_epoch;
+
+    auto& edge = m_edges[edgeId];
+    edge.inclusiveCost += cost;
+    edge.selfCost += selfCost;
+}
+
+void CallerCalleeBuilder::merge(const CallerCalleeBuilder& other)
+{
+    QVector<int> remappedEntries(other.m_result.size(), CallTree::InvalidNode);
+    for (int otherEntry = other.m_result.firstChild(CallTree::RootNode); otherEntry != CallTree::InvalidNode;
+         otherEntry = other.m_result.nextSibling(otherEntry))
+    {
+        const auto entry = this->entry(other.m_result.frameId(otherEntry));
+        m_result.addSelfCost(entry, other.m_result.selfCost(otherEntry));
+        m_result.addCost(entry, other.m_result.inclusiveCost(otherEntry), other.m_result.kernelCost(otherEntry));
+        remappedEntries[otherEntry] = entry;
+    }
+    for (const auto& otherEdge : other.m_edges) {
+        auto& edge = m_edges[this->edge(remappedEntries.at(otherEdge.caller), remappedEntries.at(otherEdge.callee))];
+        edge.selfCost += otherEdge.selfCost;
+        edge.inclusiveCost += otherEdge.inclusiveCost;
+    }
+}
+
+const CallTree& CallerCalleeBuilder::result() const
+{
+    return m_result;
+}
+
+CallGraph CallerCalleeBuilder::callGraph() const
+{
+    return CallGraph(m_result.size(), m_edges);
+}
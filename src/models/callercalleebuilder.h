@@ -0,0 +1,108 @@
+/*
+  callercalleebuilder.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <QHash>
+#include <QPair>
+#include <QVector>
+
+#include "callgraph.h"
+#include "calltree.h"
+#include "frametable.h"
+
+class StackTable;
+
+/**
+ * The identity of a caller-callee entry, all frames of a symbol in a binary share one entry.
+ */
+struct CallerCalleeLocation
+{
+    qint32 symbol = -1;
+    qint32 binary = -1;
+};
+
+bool operator==(const CallerCalleeLocation& lhs, const CallerCalleeLocation& rhs);
+uint qHash(const CallerCalleeLocation& location, uint seed = 0);
+
+Q_DECLARE_TYPEINFO(CallerCalleeLocation, Q_PRIMITIVE_TYPE);
+
+/**
+ * Builds the caller-callee data and the calls between its entries from resolved stacks.
+ *
+ * The entries are the top level nodes of the result, a symbol only adds to an entry and an
+ * edge once per stack, also when it is called recursively.
+ */
+class CallerCalleeBuilder
+{
+public:
+    explicit CallerCalleeBuilder(const FrameTable& frameTable);
+
+    void addStack(const StackTable& stacks, int stack);
+
+    /**
+     * Merge the data that @p other built from different stacks with the same frame table.
+     */
+    void merge(const CallerCalleeBuilder& other);
+
+    const CallTree& result() const;
+    CallGraph callGraph() const;
+
+private:
+    CallerCalleeLocation location(qint32 frameId) const;
+
+    /**
+     * @return the top level node in the caller-callee data for the symbol of the frame @p frameId,
+     *         which gets created on demand
+     *
+     * The node is cached per frame id, so every frame only gets hashed once.
+     */
+    int entry(qint32 frameId);
+
+    /**
+     * @return the index of the edge from @p caller to @p callee, which gets created on demand
+     */
+    int edge(int caller, int callee);
+    void addEdge(int caller, int callee, quint32 cost, quint32 selfCost);
+
+    FrameTable m_frameTable;
+    CallTree m_result;
+    // maps the symbols to their top level nodes in m_result
+    QHash<CallerCalleeLocation, int> m_entries;
+    // the top level node in m_result for every frame id, see entry
+    QVector<int> m_frameEntries;
+    // the last epoch in which a stack added to the node in m_result, see addStack
+    QVector<quint32> m_epochs;
+    quint32 m_epoch = 0;
+    // the calls between the nodes in m_result
+    QVector<CallEdge> m_edges;
+    // maps the caller and callee node to the index of their edge in m_edges
+    QHash<QPair<int, int>, int> m_edgeIds;
+    // the last epoch in which a stack added to the edge, see addEdge
+    QVector<quint32> m_edgeEpochs;
+};
@@ -41,13 +41,14 @@ int CallerCalleeModel::columnCount(const QModelIndex& parent) const
 
 int CallerCalleeModel::rowCount(const QModelIndex& parent) const
 {
-    return parent.isValid() ? 0 : m_root.children.size();
+    return parent.isValid() ? 0 : m_nodes.size();
 }
 
 QVariant CallerCalleeModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
     if (role == Qt::InitialSortOrderRole) {
-        if (section == SelfCost || section == InclusiveCost)
+        if (section == SelfCost || section == InclusiveCost
+            || section == KernelCost || section == UserCost)
         {
             return Qt::DescendingOrder;
         }
@@ -69,6 +70,10 @@ QVariant CallerCalleeModel::headerData(int section, Qt::Orientation orientation,
             return tr("Self Cost");
         case InclusiveCost:
             return tr("Inclusive Cost");
+        case KernelCost:
+            return tr("Kernel Cost");
+        case UserCost:
+            return tr("User Cost");
         case NUM_COLUMNS:
             // fall-through
             break;
@@ -83,44 +88,55 @@ QVariant CallerCalleeModel::data(const QModelIndex& index, int role) const
         return {};
     }
 
-    const auto& item = m_root.children.at(index.row());
+    const auto node = m_nodes.at(index.row());
+    const auto frameId = m_tree.frameId(node);
 
-    if (role == SortRole) {
+    if (role == FunctionRole) {
+        return node;
+    } else if (role == SortRole) {
         switch (static_cast<Columns>(index.column())) {
             case Symbol:
-                return item.symbol;
+                return m_frames.symbol(frameId);
             case Binary:
-                return item.binary;
+                return m_frames.binary(frameId);
             case Location:
-                return item.location;
+                return m_frames.location(frameId);
             case Address:
-                return item.address;
+                return m_frames.frame(frameId).address;
             case SelfCost:
-                return item.selfCost;
+                return m_tree.selfCost(node);
             case InclusiveCost:
-                return item.inclusiveCost;
+                return m_tree.inclusiveCost(node);
+            case KernelCost:
+                return m_tree.kernelCost(node);
+            case UserCost:
+                return m_tree.inclusiveCost(node) - m_tree.kernelCost(node);
             case NUM_COLUMNS:
                 // do nothing
                 break;
         }
     } else if (role == FilterRole) {
         // TODO: optimize this
-        return QString(item.symbol + item.binary + item.location);
+        return QString(m_frames.symbol(frameId) + m_frames.binary(frameId) + m_frames.location(frameId));
     } else if (role == Qt::DisplayRole) {
         // TODO: show fractional cost
         switch (static_cast<Columns>(index.column())) {
             case Symbol:
-                return item.symbol;
+                return m_frames.symbol(frameId);
             case Binary:
-                return item.binary;
+                return m_frames.binary(frameId);
             case Location:
-                return item.location;
+                return m_frames.location(frameId);
             case Address:
-                return item.address;
+                return m_frames.address(frameId);
             case SelfCost:
-                return item.selfCost;
+                return m_tree.selfCost(node);
             case InclusiveCost:
-                return item.inclusiveCost;
+                return m_tree.inclusiveCost(node);
+            case KernelCost:
+                return m_tree.kernelCost(node);
+            case UserCost:
+                return m_tree.inclusiveCost(node) - m_tree.kernelCost(node);
             case NUM_COLUMNS:
                 // do nothing
                 break;
@@ -132,9 +148,15 @@ QVariant CallerCalleeModel::data(const QModelIndex& index, int role) const
     return {};
 }
 
-void CallerCalleeModel::setData(const FrameData& data)
+void CallerCalleeModel::setData(const CallTree& data, const FrameTable& frames)
 {
     beginResetModel();
-    m_root = data;
+    m_tree = data;
+    m_frames = frames;
+    m_nodes.clear();
+    m_nodes.reserve(m_tree.childCount(CallTree::RootNode));
+    for (int node = m_tree.firstChild(CallTree::RootNode); node != CallTree::InvalidNode; node = m_tree.nextSibling(node)) {
+        m_nodes.append(node);
+    }
     endResetModel();
 }
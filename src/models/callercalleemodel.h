@@ -30,7 +30,8 @@
 #include <QVector>
 #include <QAbstractItemModel>
 
-#include "framedata.h"
+#include "calltree.h"
+#include "frametable.h"
 
 class CallerCalleeModel : public QAbstractTableModel
 {
@@ -46,12 +47,17 @@ public:
         Location,
         SelfCost,
         InclusiveCost,
+        // the split of the inclusive cost, see CostModel::KernelCost
+        KernelCost,
+        UserCost,
         NUM_COLUMNS
     };
 
     enum Roles {
         SortRole = Qt::UserRole,
-        FilterRole
+        FilterRole,
+        // the node of the function in the caller-callee data
+        FunctionRole
     };
 
     int columnCount(const QModelIndex& parent = {}) const override;
@@ -62,7 +68,13 @@ public:
     QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
 
     using QAbstractTableModel::setData;
-    void setData(const FrameData& data);
+    /**
+     * Every top level node of @p data is displayed as a row.
+     */
+    void setData(const CallTree& data, const FrameTable& frames);
 private:
-    FrameData m_root;
+    CallTree m_tree;
+    FrameTable m_frames;
+    // the node of every row
+    QVector<int> m_nodes;
 };
@@ -0,0 +1,86 @@
+/*
+  callgraph.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "callgraph.h"
+
+namespace {
+/**
+ * Sort the @p edges into compressed sparse rows of the function returned by @p key.
+ */
+template<typename Key>
+void buildRows(int functionCount, const QVector<CallEdge>& edges, Key key,
+               QVector<int>* offsets, QVector<CallEdge>* rows)
+{
+    offsets->fill(0, functionCount + 1);
+    for (const auto& edge : edges) {
+        ++(*offsets)[key(edge) + 1];
+    }
+    for (int i = 1; i <= functionCount; ++i) {
+        (*offsets)[i] += offsets->at(i - 1);
+    }
+
+    rows->resize(edges.size());
+    auto next = *offsets;
+    for (const auto& edge : edges) {
+        (*rows)[next[key(edge)]++] = edge;
+    }
+}
+}
+
+CallGraph::CallGraph(int functionCount, const QVector<CallEdge>& edges)
+{
+    buildRows(functionCount, edges, [](const CallEdge& edge) { return edge.callee; },
+              &m_callerOffsets, &m_callers);
+    buildRows(functionCount, edges, [](const CallEdge& edge) { return edge.caller; },
+              &m_calleeOffsets, &m_callees);
+}
+
+int CallGraph::callerCount(int function) const
+{
+    if (function < 0 || function + 1 >= m_callerOffsets.size()) {
+        return 0;
+    }
+    return m_callerOffsets.at(function + 1) - m_callerOffsets.at(function);
+}
+
+const CallEdge& CallGraph::caller(int function, int index) const
+{
+    return m_callers.at(m_callerOffsets.at(function) + index);
+}
+
+int CallGraph::calleeCount(int function) const
+{
+    if (function < 0 || function + 1 >= m_calleeOffsets.size()) {
+        return 0;
+    }
+    return m_calleeOffsets.at(function + 1) - m_calleeOffsets.at(function);
+}
+
+const CallEdge& CallGraph::callee(int function, int index) const
+{
+    return m_callees.at(m_calleeOffsets.at(function) + index);
+}
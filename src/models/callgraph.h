@@ -0,0 +1,76 @@
+/*
+  callgraph.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QMetaType>
+#include <QVector>
+
+/**
+ * A call from the function @p caller to the function @p callee.
+ *
+ * The inclusive cost is the cost of all samples with this call in their stack,
+ * the self cost is the part of it in which the callee was the innermost frame.
+ */
+struct CallEdge
+{
+    int caller = -1;
+    int callee = -1;
+    quint32 selfCost = 0;
+    quint32 inclusiveCost = 0;
+};
+
+Q_DECLARE_TYPEINFO(CallEdge, Q_PRIMITIVE_TYPE);
+
+/**
+ * The callers and callees of every function, stored as compressed sparse rows.
+ *
+ * The functions are identified by their nodes in the caller-callee tree. All edges of a
+ * function are stored next to each other, so they can be listed without any lookup.
+ */
+class CallGraph
+{
+public:
+    CallGraph() = default;
+    CallGraph(int functionCount, const QVector<CallEdge>& edges);
+
+    int callerCount(int function) const;
+    const CallEdge& caller(int function, int index) const;
+
+    int calleeCount(int function) const;
+    const CallEdge& callee(int function, int index) const;
+
+private:
+    // the edges of function i are stored in [offsets[i], offsets[i + 1])
+    QVector<int> m_callerOffsets;
+    QVector<CallEdge> m_callers;
+    QVector<int> m_calleeOffsets;
+    QVector<CallEdge> m_callees;
+};
+
+Q_DECLARE_METATYPE(CallGraph)
+Q_DECLARE_TYPEINFO(CallGraph, Q_MOVABLE_TYPE);
@@ -0,0 +1,161 @@
+/*
+  calltree.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "calltree.h"
+
+CallTree::CallTree()
+{
+    // the root node has no frame
+    appendNode(InvalidNode, -1);
+}
+
+int CallTree::size() const
+{
+    return m_frameIds.size();
+}
+
+qint32 CallTree::frameId(int node) const
+{
+    return m_frameIds.at(node);
+}
+
+int CallTree::parent(int node) const
+{
+    return m_parents.at(node);
+}
+
+int CallTree::firstChild(int node) const
+{
+    return m_firstChildren.at(node);
+}
+
+int CallTree::nextSibling(int node) const
+{
+    return m_nextSiblings.at(node);
+}
+
+int CallTree::childCount(int node) const
+{
+    return m_childCounts.at(node);
+}
+
+quint32 CallTree::selfCost(int node) const
+{
+    return m_selfCosts.at(node);
+}
+
+quint32 CallTree::inclusiveCost(int node) const
+{
+    return m_inclusiveCosts.at(node);
+}
+
+quint32 CallTree::kernelCost(int node) const
+{
+    return m_kernelCosts.at(node);
+}
+
+int CallTree::addChild(int parent, qint32 frameId)
+{
+    Q_ASSERT(frameId != -1);
+
+    // scanning a few siblings is cheaper than a hash lookup, wide nodes get an index though
+    if (m_childCounts.at(parent) < MinChildIndexSize) {
+        for (int child = m_firstChildren.at(parent); child != InvalidNode; child = m_nextSiblings.at(child)) {
+            if (m_frameIds.at(child) == frameId) {
+                return child;
+            }
+        }
+    } else {
+        const auto child = m_childIndex.value(qMakePair(parent, frameId), InvalidNode);
+        if (child != InvalidNode) {
+            return child;
+        }
+    }
+
+    const auto node = appendNode(parent, frameId);
+    if (m_childCounts.at(parent) == MinChildIndexSize) {
+        for (int child = m_firstChildren.at(parent); child != InvalidNode; child = m_nextSiblings.at(child)) {
+            m_childIndex.insert(qMakePair(parent, m_frameIds.at(child)), child);
+        }
+    } else if (m_childCounts.at(parent) > MinChildIndexSize) {
+        m_childIndex.insert(qMakePair(parent, frameId), node);
+    }
+    return node;
+}
+
+int CallTree::appendNode(int parent, qint32 frameId)
+{
+    const int node = m_frameIds.size();
+    m_frameIds.append(frameId);
+    m_parents.append(parent);
+    m_firstChildren.append(InvalidNode);
+    m_lastChildren.append(InvalidNode);
+    m_nextSiblings.append(InvalidNode);
+    m_childCounts.append(0);
+    m_selfCosts.append(0);
+    m_inclusiveCosts.append(0);
+    m_kernelCosts.append(0);
+
+    if (parent != InvalidNode) {
+        // append the node to the children of the parent, to keep them in the order of their creation
+        auto& lastChild = m_lastChildren[parent];
+        if (lastChild == InvalidNode) {
+            m_firstChildren[parent] = node;
+        } else {
+            m_nextSiblings[lastChild] = node;
+        }
+        lastChild = node;
+        ++m_childCounts[parent];
+    }
+    return node;
+}
+
+void CallTree::addCost(int node, quint32 cost, quint32 kernelCost)
+{
+    m_inclusiveCosts[node] += cost;
+    m_kernelCosts[node] += kernelCost;
+}
+
+void CallTree::addSelfCost(int node, quint32 cost)
+{
+    m_selfCosts[node] += cost;
+}
+
+void CallTree::merge(const CallTree& other)
+{
+    // parents are always created before their children, so a single pass visits them first
+    QVector<int> nodes(other.size());
+    nodes[RootNode] = RootNode;
+    addCost(RootNode, other.inclusiveCost(RootNode), other.kernelCost(RootNode));
+    addSelfCost(RootNode, other.selfCost(RootNode));
+    for (int otherNode = RootNode + 1, c = other.size(); otherNode < c; ++otherNode) {
+        const auto node = addChild(nodes.at(other.parent(otherNode)), other.frameId(otherNode));
+        addCost(node, other.inclusiveCost(otherNode), other.kernelCost(otherNode));
+        addSelfCost(node, other.selfCost(otherNode));
+        nodes[otherNode] = node;
+    }
+}
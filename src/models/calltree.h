@@ -0,0 +1,103 @@
+/*
+  calltree.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QMetaType>
+#include <QPair>
+#include <QVector>
+
+/**
+ * An aggregated call tree, stored as a flat pool of nodes.
+ *
+ * The nodes are addressed by their index, which stays stable while the tree grows.
+ * Every attribute of the nodes is stored in a separate column and the children of
+ * a node are linked through their siblings. The columns are implicitly shared, so
+ * copies of the tree are cheap and can be passed to other threads.
+ *
+ * The frame ids reference the FrameTable the tree was built with.
+ */
+class CallTree
+{
+public:
+    CallTree();
+
+    enum : int {
+        InvalidNode = -1,
+        RootNode = 0
+    };
+
+    enum {
+        // the children of nodes with more children are looked up through a hash
+        MinChildIndexSize = 16
+    };
+
+    int size() const;
+
+    qint32 frameId(int node) const;
+    int parent(int node) const;
+    int firstChild(int node) const;
+    int nextSibling(int node) const;
+    int childCount(int node) const;
+
+    // TODO: abstract that away: there may be multiple costs per frame
+    quint32 selfCost(int node) const;
+    quint32 inclusiveCost(int node) const;
+    // the part of the inclusive cost of samples that were taken in kernel space
+    quint32 kernelCost(int node) const;
+
+    /**
+     * @return the child of @p parent for the frame @p frameId, which gets created on demand
+     */
+    int addChild(int parent, qint32 frameId);
+    void addCost(int node, quint32 cost, quint32 kernelCost);
+    void addSelfCost(int node, quint32 cost);
+
+    /**
+     * Merge the @p other tree, which references the same frame ids, into this one.
+     */
+    void merge(const CallTree& other);
+
+private:
+    int appendNode(int parent, qint32 frameId);
+
+    QVector<qint32> m_frameIds;
+    QVector<int> m_parents;
+    QVector<int> m_firstChildren;
+    QVector<int> m_lastChildren;
+    QVector<int> m_nextSiblings;
+    QVector<int> m_childCounts;
+    QVector<quint32> m_selfCosts;
+    QVector<quint32> m_inclusiveCosts;
+    QVector<quint32> m_kernelCosts;
+    // maps the parent node and the frame id to the child node, only used for wide nodes
+    QHash<QPair<int, qint32>, int> m_childIndex;
+};
+
+Q_DECLARE_METATYPE(CallTree)
+Q_DECLARE_TYPEINFO(CallTree, Q_MOVABLE_TYPE);
@@ -0,0 +1,98 @@
+/*
+  chunkmerger.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <memory>
+#include <vector>
+
+/**
+ * Merges the results that are built concurrently from consecutive chunks of the stacks.
+ *
+ * The results get merged pairwise like in a binary tree. A result is merged with the one of
+ * its neighboring chunk as soon as both are ready, and the one of the earlier chunk absorbs the
+ * other. Merges of different pairs run concurrently, the lock is only held to hand over a result.
+ * The merged result thus is the same as if the chunks were merged in their order, no matter in
+ * which order they finish.
+ */
+template<typename Result>
+class ChunkMerger
+{
+public:
+    explicit ChunkMerger(int chunkCount)
+        : m_chunkCount(chunkCount)
+    {
+        for (int count = chunkCount; count > 1; count = (count + 1) / 2) {
+            m_pending.emplace_back((count + 1) / 2);
+        }
+    }
+
+    /**
+     * Add the @p result of the chunk with the index @p chunk, results get combined with @p merge.
+     *
+     * @return the merged result of all chunks when this was the last merge, else null
+     */
+    template<typename Merge>
+    std::unique_ptr<Result> addChunk(int chunk, std::unique_ptr<Result> result, Merge merge)
+    {
+        int index = chunk;
+        int count = m_chunkCount;
+        for (int level = 0; count > 1; ++level) {
+            const int neighbor = index ^ 1;
+            if (neighbor < count) {
+                std::unique_ptr<Result> other;
+                {
+                    QMutexLocker lock(&m_mutex);
+                    auto& pending = m_pending[level][index / 2];
+                    if (!pending) {
+                        // the job that finishes the neighbor merges both
+                        pending = std::move(result);
+                        return {};
+                    }
+                    other = std::move(pending);
+                }
+                if (neighbor < index) {
+                    std::swap(result, other);
+                }
+                merge(result.get(), *other);
+            }
+            index /= 2;
+            count = (count + 1) / 2;
+        }
+        return result;
+    }
+
+private:
+    QMutex m_mutex;
+    int m_chunkCount;
+    // the results that wait for their neighbor, per level of the binary tree
+    std::vector<std::vector<std::unique_ptr<Result>>> m_pending;
+};
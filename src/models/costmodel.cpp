@@ -38,11 +38,13 @@ int CostModel::rowCount(const QModelIndex& parent) const
 {
     if (parent.column() >= 1) {
         return 0;
-    } else if (auto item = itemFromIndex(parent)) {
-        return item->children.size();
-    } else {
+    }
+
+    const auto node = nodeFromIndex(parent);
+    if (node == CallTree::InvalidNode) {
         return 0;
     }
+    return m_tree.childCount(node);
 }
 
 int CostModel::columnCount(const QModelIndex& parent) const
@@ -60,22 +62,22 @@ QModelIndex CostModel::index(int row, int column, const QModelIndex& parent) con
         return {};
     }
 
-    const auto* parentItem = itemFromIndex(parent);
-    if (!parentItem) {
+    const auto parentNode = nodeFromIndex(parent);
+    if (parentNode == CallTree::InvalidNode) {
         return {};
     }
 
-    return createIndex(row, column, const_cast<FrameData*>(parentItem));
+    return createIndex(row, column, quintptr(parentNode));
 }
 
 QModelIndex CostModel::parent(const QModelIndex& child) const
 {
-    const auto* childItem = itemFromIndex(child);
-    if (!childItem) {
+    const auto childNode = nodeFromIndex(child);
+    if (childNode == CallTree::InvalidNode) {
         return {};
     }
 
-    return indexFromItem(childItem->parent, 0);
+    return indexFromNode(m_tree.parent(childNode), 0);
 }
 
 QVariant CostModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -97,6 +99,10 @@ QVariant CostModel::headerData(int section, Qt::Orientation orientation, int rol
             return tr("Self Cost");
         case InclusiveCost:
             return tr("Inclusive Cost");
+        case KernelCost:
+            return tr("Kernel Cost");
+        case UserCost:
+            return tr("User Cost");
         case NUM_COLUMNS:
             // fall-through
             break;
@@ -107,47 +113,58 @@ QVariant CostModel::headerData(int section, Qt::Orientation orientation, int rol
 
 QVariant CostModel::data(const QModelIndex& index, int role) const
 {
-    const auto* item = itemFromIndex(index);
-    if (!item) {
+    const auto node = nodeFromIndex(index);
+    if (node == CallTree::InvalidNode) {
         return {};
     }
+    const auto frameId = m_tree.frameId(node);
 
-    if (role == SortRole) {
+    if (role == FrameRole) {
+        return frameId;
+    } else if (role == SortRole) {
         switch (static_cast<Columns>(index.column())) {
             case Symbol:
-                return item->symbol;
+                return m_frames.symbol(frameId);
             case Binary:
-                return item->binary;
+                return m_frames.binary(frameId);
             case Location:
-                return item->location;
+                return m_frames.location(frameId);
             case Address:
-                return item->address;
+                return m_frames.frame(frameId).address;
             case SelfCost:
-                return item->selfCost;
+                return m_tree.selfCost(node);
             case InclusiveCost:
-                return item->inclusiveCost;
+                return m_tree.inclusiveCost(node);
+            case KernelCost:
+                return m_tree.kernelCost(node);
+            case UserCost:
+                return m_tree.inclusiveCost(node) - m_tree.kernelCost(node);
             case NUM_COLUMNS:
                 // do nothing
                 break;
         }
     } else if (role == FilterRole) {
         // TODO: optimize
-        return QString(item->symbol + item->binary + item->location);
+        return QString(m_frames.symbol(frameId) + m_frames.binary(frameId) + m_frames.location(frameId));
     } else if (role == Qt::DisplayRole) {
         // TODO: show fractional cost
         switch (static_cast<Columns>(index.column())) {
             case Symbol:
-                return item->symbol;
+                return m_frames.symbol(frameId);
             case Binary:
-                return item->binary;
+                return m_frames.binary(frameId);
             case Location:
-                return item->location;
+                return m_frames.location(frameId);
             case Address:
-                return item->address;
+                return m_frames.address(frameId);
             case SelfCost:
-                return item->selfCost;
+                return m_tree.selfCost(node);
             case InclusiveCost:
-                return item->inclusiveCost;
+                return m_tree.inclusiveCost(node);
+            case KernelCost:
+                return m_tree.kernelCost(node);
+            case UserCost:
+                return m_tree.inclusiveCost(node) - m_tree.kernelCost(node);
             case NUM_COLUMNS:
                 // do nothing
                 break;
@@ -159,39 +176,47 @@ QVariant CostModel::data(const QModelIndex& index, int role) const
     return {};
 }
 
-void CostModel::setData(const FrameData& data)
+void CostModel::setData(const CallTree& tree, const FrameTable& frames)
 {
     beginResetModel();
-    m_root = data;
+    m_tree = tree;
+    m_frames = frames;
+
+    // index the children of all nodes, to look up rows in constant time
+    m_children.clear();
+    m_children.reserve(m_tree.size());
+    m_childOffsets.resize(m_tree.size());
+    m_rows.resize(m_tree.size());
+    for (int node = 0, c = m_tree.size(); node < c; ++node) {
+        m_childOffsets[node] = m_children.size();
+        int row = 0;
+        for (int child = m_tree.firstChild(node); child != CallTree::InvalidNode; child = m_tree.nextSibling(child)) {
+            m_children.append(child);
+            m_rows[child] = row++;
+        }
+    }
     endResetModel();
 }
 
-const FrameData* CostModel::itemFromIndex(const QModelIndex& index) const
+int CostModel::nodeFromIndex(const QModelIndex& index) const
 {
     if (!index.isValid()) {
-        return &m_root;
-    } else {
-        auto parent = reinterpret_cast<const FrameData*>(index.internalPointer());
-        if (index.row() >= parent->children.size()) {
-            return nullptr;
-        }
-        return parent->children.constData() + index.row();
+        return CallTree::RootNode;
+    }
+
+    const auto parentNode = static_cast<int>(index.internalId());
+    if (index.row() >= m_tree.childCount(parentNode)) {
+        return CallTree::InvalidNode;
     }
+    return m_children.at(m_childOffsets.at(parentNode) + index.row());
 }
 
-QModelIndex CostModel::indexFromItem(const FrameData* item, int column) const
+QModelIndex CostModel::indexFromNode(int node, int column) const
 {
-    if (!item) {
+    // the root node is not visible
+    if (node == CallTree::InvalidNode || node == CallTree::RootNode) {
         return {};
     }
 
-    const auto* parentItem = item->parent;
-    if (!parentItem) {
-        parentItem = &m_root;
-    }
-    Q_ASSERT(parentItem->children.constData() <= item);
-    Q_ASSERT(parentItem->children.constData() + parentItem->children.size() > item);
-    const int row = std::distance(parentItem->children.constData(), item);
-
-    return createIndex(row, column, const_cast<FrameData*>(parentItem));
+    return createIndex(m_rows.at(node), column, quintptr(m_tree.parent(node)));
 }
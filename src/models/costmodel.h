@@ -29,7 +29,8 @@
 
 #include <QAbstractItemModel>
 
-#include "framedata.h"
+#include "calltree.h"
+#include "frametable.h"
 
 class CostModel : public QAbstractItemModel
 {
@@ -46,12 +47,20 @@ public:
         Location,
         SelfCost,
         InclusiveCost,
+        // the inclusive cost split into the samples taken in kernel and in user space.
+        // The self cost is not split: the innermost frame of a sample decides where it was
+        // taken, so the self cost of kernel frames is kernel cost and all other is user cost.
+        // Only folding rules that collapse kernel frames into their caller break this rule.
+        KernelCost,
+        UserCost,
         NUM_COLUMNS
     };
 
     enum Roles {
         SortRole = Qt::UserRole,
-        FilterRole
+        FilterRole,
+        // the id of the frame of a row in the frame table
+        FrameRole
     };
 
     int columnCount(const QModelIndex& parent = {}) const override;
@@ -64,11 +73,17 @@ public:
     QVariant data(const QModelIndex& index, int role) const override;
 
     using QAbstractItemModel::setData;
-    void setData(const FrameData& data);
+    void setData(const CallTree& tree, const FrameTable& frames);
 
 private:
-    const FrameData* itemFromIndex(const QModelIndex& index) const;
-    QModelIndex indexFromItem(const FrameData* item, int column) const;
-
-    FrameData m_root;
+    int nodeFromIndex(const QModelIndex& index) const;
+    QModelIndex indexFromNode(int node, int column) const;
+
+    CallTree m_tree;
+    FrameTable m_frames;
+    // the children of every node, the ones of a node start at its entry in m_childOffsets
+    QVector<int> m_children;
+    QVector<int> m_childOffsets;
+    // the row of every node below its parent
+    QVector<int> m_rows;
 };
@@ -0,0 +1,99 @@
+/*
+  foldingrule.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "foldingrule.h"
+
+namespace {
+const auto collapseAction = QStringLiteral("collapse");
+const auto mergeAction = QStringLiteral("merge");
+const auto symbolTarget = QStringLiteral("symbol");
+const auto binaryTarget = QStringLiteral("binary");
+const auto frameNameSeparator = QStringLiteral(" -> ");
+}
+
+bool FoldingRule::matches(const QString& symbol, const QString& binary) const
+{
+    return pattern.match(target == Symbol ? symbol : binary).hasMatch();
+}
+
+QString FoldingRule::toString() const
+{
+    auto text = QString((action == CollapseIntoCaller ? collapseAction : mergeAction) + QLatin1Char(' ')
+                        + (target == Symbol ? symbolTarget : binaryTarget) + QLatin1Char(' ')
+                        + pattern.pattern());
+    if (action == MergeIntoFrame) {
+        text += frameNameSeparator + frameName;
+    }
+    return text;
+}
+
+bool FoldingRule::fromString(const QString& text, FoldingRule* rule)
+{
+    // the pattern may contain spaces, so only the action and the target are split off
+    const auto trimmed = text.trimmed();
+    const auto actionEnd = trimmed.indexOf(QLatin1Char(' '));
+    const auto targetEnd = trimmed.indexOf(QLatin1Char(' '), actionEnd + 1);
+    if (actionEnd == -1 || targetEnd == -1) {
+        return false;
+    }
+
+    const auto action = trimmed.left(actionEnd);
+    if (action == collapseAction) {
+        rule->action = CollapseIntoCaller;
+    } else if (action == mergeAction) {
+        rule->action = MergeIntoFrame;
+    } else {
+        return false;
+    }
+
+    const auto target = trimmed.mid(actionEnd + 1, targetEnd - actionEnd - 1);
+    if (target == symbolTarget) {
+        rule->target = Symbol;
+    } else if (target == binaryTarget) {
+        rule->target = Binary;
+    } else {
+        return false;
+    }
+
+    auto pattern = trimmed.mid(targetEnd + 1).trimmed();
+    if (rule->action == MergeIntoFrame) {
+        const auto separator = pattern.lastIndexOf(frameNameSeparator);
+        if (separator == -1) {
+            return false;
+        }
+        rule->frameName = pattern.mid(separator + frameNameSeparator.size()).trimmed();
+        pattern = pattern.left(separator).trimmed();
+        if (rule->frameName.isEmpty()) {
+            return false;
+        }
+    } else {
+        rule->frameName.clear();
+    }
+
+    rule->pattern.setPattern(pattern);
+    return !pattern.isEmpty() && rule->pattern.isValid();
+}
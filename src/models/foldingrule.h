@@ -0,0 +1,75 @@
+/*
+  foldingrule.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QRegularExpression>
+#include <QString>
+#include <QVector>
+
+/**
+ * A rule that folds the frames whose symbol or binary matches a pattern while a profile is parsed.
+ *
+ * Matching frames either get collapsed into their caller, or merged into a frame with the
+ * given name. Consecutive frames that get merged by the same rule only show up once.
+ */
+struct FoldingRule
+{
+    enum Target
+    {
+        Symbol,
+        Binary
+    };
+
+    enum Action
+    {
+        CollapseIntoCaller,
+        MergeIntoFrame
+    };
+
+    Action action = CollapseIntoCaller;
+    Target target = Symbol;
+    QRegularExpression pattern;
+    // the symbol of the frame that matching frames get merged into
+    QString frameName;
+
+    bool matches(const QString& symbol, const QString& binary) const;
+
+    /**
+     * The rules are written as "collapse symbol <pattern>" or "merge binary <pattern> -> <name>".
+     */
+    QString toString() const;
+
+    /**
+     * Parse the @p text of a rule into @p rule.
+     *
+     * @return false when the text is not a valid rule, see toString
+     */
+    static bool fromString(const QString& text, FoldingRule* rule);
+};
+
+Q_DECLARE_TYPEINFO(FoldingRule, Q_MOVABLE_TYPE);
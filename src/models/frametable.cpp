@@ -0,0 +1,174 @@
+/*
+  frametable.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "frametable.h"
+
+#include <util.h>
+
+#include <cstring>
+
+bool operator==(const Frame& lhs, const Frame& rhs)
+{
+    return lhs.address == rhs.address && lhs.symbol == rhs.symbol && lhs.binary == rhs.binary
+        && lhs.file == rhs.file && lhs.line == rhs.line && lhs.column == rhs.column
+        && lhs.isKernel == rhs.isKernel && lhs.isProcess == rhs.isProcess;
+}
+
+uint qHash(const Frame& frame, uint seed)
+{
+    Util::HashCombine hash;
+    seed = hash(seed, frame.address);
+    seed = hash(seed, frame.symbol);
+    seed = hash(seed, frame.binary);
+    seed = hash(seed, frame.file);
+    seed = hash(seed, frame.line);
+    seed = hash(seed, frame.column);
+    seed = hash(seed, frame.isKernel);
+    seed = hash(seed, frame.isProcess);
+    return seed;
+}
+
+qint32 FrameTable::internString(const QByteArray& string)
+{
+    return internString(string.constData(), string.size());
+}
+
+qint32 FrameTable::internString(const QString& string)
+{
+    return internString(string.toUtf8());
+}
+
+qint32 FrameTable::internString(const char* data, int size)
+{
+    if (size == 0) {
+        return -1;
+    }
+
+    const auto hash = qHashBits(data, size);
+    for (auto it = m_stringIds.find(hash), end = m_stringIds.end(); it != end && it.key() == hash; ++it) {
+        if (stringSize(it.value()) == size && std::memcmp(stringData(it.value()), data, size) == 0) {
+            return it.value();
+        }
+    }
+
+    const qint32 id = m_stringOffsets.size();
+    m_stringOffsets.append(m_stringData.size());
+    m_stringData.append(data, size);
+    m_stringIds.insert(hash, id);
+    return id;
+}
+
+const char* FrameTable::stringData(qint32 id) const
+{
+    return m_stringData.constData() + m_stringOffsets.at(id);
+}
+
+int FrameTable::stringSize(qint32 id) const
+{
+    const auto end = id + 1 < m_stringOffsets.size() ? m_stringOffsets.at(id + 1) : quint32(m_stringData.size());
+    return end - m_stringOffsets.at(id);
+}
+
+QString FrameTable::string(qint32 id) const
+{
+    if (id < 0 || id >= m_stringOffsets.size()) {
+        return {};
+    }
+    return QString::fromUtf8(stringData(id), stringSize(id));
+}
+
+qint32 FrameTable::internFrame(const Frame& frame)
+{
+    auto it = m_frameIds.find(frame);
+    if (it == m_frameIds.end()) {
+        it = m_frameIds.insert(frame, m_frames.size());
+        m_frames.append(frame);
+    }
+    return it.value();
+}
+
+Frame FrameTable::frame(qint32 id) const
+{
+    return m_frames.value(id);
+}
+
+int FrameTable::frameCount() const
+{
+    return m_frames.size();
+}
+
+QString FrameTable::symbol(qint32 frameId) const
+{
+    return string(frame(frameId).symbol);
+}
+
+QString FrameTable::binary(qint32 frameId) const
+{
+    return string(frame(frameId).binary);
+}
+
+QString FrameTable::location(qint32 frameId) const
+{
+    const auto frame = this->frame(frameId);
+    if (frame.file == -1) {
+        return {};
+    }
+
+    auto location = string(frame.file);
+    if (frame.line != -1) {
+        location += QLatin1Char(':') + QString::number(frame.line);
+    }
+    return location;
+}
+
+QString FrameTable::address(qint32 frameId) const
+{
+    const auto address = frame(frameId).address;
+    return address ? QString::number(address, 16) : QString();
+}
+
+QVector<qint32> FrameTable::merge(const FrameTable& other)
+{
+    QVector<qint32> stringIds;
+    stringIds.reserve(other.m_stringOffsets.size());
+    for (qint32 id = 0, c = other.m_stringOffsets.size(); id < c; ++id) {
+        stringIds.append(internString(other.stringData(id), other.stringSize(id)));
+    }
+    auto remap = [&stringIds](qint32 id) {
+        return id == -1 ? -1 : stringIds.at(id);
+    };
+
+    QVector<qint32> frameIds;
+    frameIds.reserve(other.m_frames.size());
+    for (auto frame : other.m_frames) {
+        frame.symbol = remap(frame.symbol);
+        frame.binary = remap(frame.binary);
+        frame.file = remap(frame.file);
+        frameIds.append(internFrame(frame));
+    }
+    return frameIds;
+}
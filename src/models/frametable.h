@@ -0,0 +1,127 @@
+/*
+  frametable.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+/**
+ * The identity of a frame, symbol, binary and file are string ids of the FrameTable.
+ *
+ * An id of -1 denotes an empty string, a line or column of -1 is unknown.
+ */
+struct Frame
+{
+    quint64 address = 0;
+    qint32 symbol = -1;
+    qint32 binary = -1;
+    qint32 file = -1;
+    qint32 line = -1;
+    qint32 column = -1;
+    bool isKernel = false;
+    // groups all samples of a process, the symbol is the name of the process and the file is
+    // the input it was recorded in, so that processes of different inputs stay apart
+    bool isProcess = false;
+
+    /**
+     * @return whether the samples can be focused on or excluded by the symbol of the frame,
+     *         process frames are not part of the stacks that get filtered
+     */
+    bool isFilterable() const
+    {
+        return !isProcess && symbol != -1;
+    }
+};
+
+bool operator==(const Frame& lhs, const Frame& rhs);
+uint qHash(const Frame& frame, uint seed = 0);
+
+Q_DECLARE_TYPEINFO(Frame, Q_PRIMITIVE_TYPE);
+
+/**
+ * The interned strings and frames of a profile.
+ *
+ * The trees only hold the ids of their frames, the text of a frame is only looked up
+ * when it gets displayed. Copies of the table are cheap, since its containers are
+ * implicitly shared.
+ *
+ * The strings are stored back to back in a single UTF-8 buffer, they only get converted
+ * to a QString when they are requested.
+ */
+class FrameTable
+{
+public:
+    /**
+     * @return the id of the UTF-8 encoded @p string, or -1 when it is empty
+     */
+    qint32 internString(const QByteArray& string);
+    qint32 internString(const QString& string);
+    QString string(qint32 id) const;
+
+    qint32 internFrame(const Frame& frame);
+    Frame frame(qint32 id) const;
+    int frameCount() const;
+
+    QString symbol(qint32 frameId) const;
+    QString binary(qint32 frameId) const;
+    /**
+     * @return the file and line of the frame, formatted as "file:line"
+     */
+    QString location(qint32 frameId) const;
+    /**
+     * @return the hexadecimal address of the frame, or an empty string if it has none
+     */
+    QString address(qint32 frameId) const;
+
+    /**
+     * Intern all frames of @p other into this table.
+     *
+     * @return the ids of the frames in this table, indexed by their ids in @p other
+     */
+    QVector<qint32> merge(const FrameTable& other);
+
+private:
+    qint32 internString(const char* data, int size);
+    const char* stringData(qint32 id) const;
+    int stringSize(qint32 id) const;
+
+    // the UTF-8 data of all strings, without separators
+    QByteArray m_stringData;
+    // the offset of every string in m_stringData, it ends where the next one starts
+    QVector<quint32> m_stringOffsets;
+    // maps the hash of the string data to the ids of the strings with that hash
+    QMultiHash<uint, qint32> m_stringIds;
+    QVector<Frame> m_frames;
+    QHash<Frame, qint32> m_frameIds;
+};
+
+Q_DECLARE_METATYPE(FrameTable)
+Q_DECLARE_TYPEINFO(FrameTable, Q_MOVABLE_TYPE);
@@ -0,0 +1,107 @@
+/*
+  locationtable.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "locationtable.h"
+
+LocationTable::LocationTable(FrameTable* frames)
+    : m_frames(frames)
+{
+}
+
+int LocationTable::size() const
+{
+    return m_locations.size();
+}
+
+void LocationTable::addLocation(qint32 parentLocationId, quint64 address, qint32 file, qint32 line, qint32 column)
+{
+    m_locations.append({parentLocationId, address, file, line, column});
+    m_symbols.append({-1, -1, false});
+}
+
+void LocationTable::setSymbol(qint32 id, qint32 symbol, qint32 binary, bool isKernel)
+{
+    Q_ASSERT(id >= 0 && id < m_symbols.size());
+    m_symbols[id] = {symbol, binary, isKernel};
+}
+
+const QVector<qint32>& LocationTable::framesForLocation(qint32 id)
+{
+    static const QVector<qint32> invalidLocation;
+    if (id < 0 || id >= m_locations.size()) {
+        return invalidLocation;
+    }
+
+    if (m_resolvedLocations.size() != m_locations.size()) {
+        m_resolvedLocations.resize(m_locations.size());
+    }
+    // every valid location yields at least one frame
+    auto& frames = m_resolvedLocations[id];
+    if (frames.isEmpty()) {
+        resolveLocation(id, &frames);
+    }
+    return frames;
+}
+
+void LocationTable::resolveLocation(qint32 id, QVector<qint32>* frames)
+{
+    static const Symbol invalidSymbol = {-1, -1, false};
+    auto symbolAt = [this](qint32 symbolId) -> const Symbol& {
+        return symbolId >= 0 && symbolId < m_symbols.size() ? m_symbols.at(symbolId) : invalidSymbol;
+    };
+
+    bool skipNextFrame = false;
+    while (id >= 0 && id < m_locations.size()) {
+        const auto& location = m_locations.at(id);
+        if (skipNextFrame) {
+            id = location.parentLocationId;
+            skipNextFrame = false;
+            continue;
+        }
+
+        const auto* symbol = &symbolAt(id);
+        if (!symbol->isValid()) {
+            // we get function entry points from the perfparser but
+            // those are imo not interesting - skip them
+            symbol = &symbolAt(location.parentLocationId);
+            skipNextFrame = true;
+        }
+
+        Frame frame;
+        frame.symbol = symbol->symbol;
+        frame.binary = symbol->binary;
+        frame.address = location.address;
+        frame.file = location.file;
+        frame.line = location.line;
+        frame.column = location.column;
+        frame.isKernel = symbol->isKernel;
+        frames->append(m_frames->internFrame(frame));
+
+        id = location.parentLocationId;
+    }
+}
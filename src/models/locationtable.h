@@ -0,0 +1,99 @@
+/*
+  locationtable.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <QVector>
+
+#include "frametable.h"
+
+/**
+ * The locations of a profile with their symbols, which get resolved into frames.
+ *
+ * A location can have a parent location, i.e. the function it got inlined into, so a location
+ * resolves to the frames of its whole chain of parents. The frames of a location are resolved
+ * when it is encountered for the first time, afterwards they are taken from a cache that is
+ * indexed by the location id.
+ */
+class LocationTable
+{
+public:
+    /**
+     * The resolved frames get interned into @p frames, which has to outlive the table.
+     */
+    explicit LocationTable(FrameTable* frames);
+
+    int size() const;
+
+    /**
+     * Add the location with the next id, the @p file is a string id of the frame table.
+     */
+    void addLocation(qint32 parentLocationId, quint64 address, qint32 file, qint32 line, qint32 column);
+
+    /**
+     * Set the symbol of the location @p id, the @p symbol and @p binary are string ids of the frame table.
+     */
+    void setSymbol(qint32 id, qint32 symbol, qint32 binary, bool isKernel);
+
+    /**
+     * @return the ids of the frames for the location @p id, starting with the location itself
+     *         and followed by the ones it was inlined into
+     */
+    const QVector<qint32>& framesForLocation(qint32 id);
+
+private:
+    struct Location
+    {
+        qint32 parentLocationId;
+        quint64 address;
+        qint32 file;
+        qint32 line;
+        qint32 column;
+    };
+
+    struct Symbol
+    {
+        qint32 symbol;
+        qint32 binary;
+        bool isKernel;
+
+        bool isValid() const
+        {
+            return symbol != -1 || binary != -1;
+        }
+    };
+
+    void resolveLocation(qint32 id, QVector<qint32>* frames);
+
+    FrameTable* m_frames;
+    QVector<Location> m_locations;
+    // the symbol of every location
+    QVector<Symbol> m_symbols;
+    // the resolved frame ids per location id, see framesForLocation
+    QVector<QVector<qint32>> m_resolvedLocations;
+};
@@ -0,0 +1,80 @@
+/*
+  parsedinput.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "parsedinput.h"
+
+#include <algorithm>
+
+void ParsedInput::merge(const ParsedInput& other)
+{
+    const auto remappedIds = frameTable.merge(other.frameTable);
+
+    const auto stackOffset = stackTable.size();
+    stackTable.append(other.stackTable, remappedIds);
+
+    // the inputs were potentially recorded on different machines with
+    // unrelated clocks, so align their time lines at the first sample
+    const auto& otherSummary = other.summaryResult;
+    qint64 timeOffset = 0;
+    if (summaryResult.applicationStartTime == 0) {
+        summaryResult.applicationStartTime = otherSummary.applicationStartTime;
+    } else if (otherSummary.applicationStartTime != 0) {
+        timeOffset = qint64(summaryResult.applicationStartTime) - qint64(otherSummary.applicationStartTime);
+    }
+    sampleStore.merge(other.sampleStore, stackOffset, timeOffset);
+    // the offset is not a multiple of the bucket size, so the buckets of the other time line
+    // cannot be shifted, instead its samples get sorted into the buckets by their aligned time
+    for (const auto& sample : other.sampleStore.samples()) {
+        timeline.addSample(quint64(qint64(sample.time) + timeOffset), sample.stack + stackOffset);
+    }
+    threadTable.append(other.threadTable, stackOffset);
+    sourceCosts.merge(other.sourceCosts);
+    summaryResult.applicationRunningTime = std::max(summaryResult.applicationRunningTime,
+                                                    otherSummary.applicationRunningTime);
+    for (auto time : other.lostTimes) {
+        lostTimes.append(time + timeOffset);
+    }
+    calculateLostIntervals();
+
+    // neither are threads and processes of different inputs related
+    summaryResult.threadCount += otherSummary.threadCount;
+    summaryResult.processCount += otherSummary.processCount;
+
+    summaryResult.sampleCount += otherSummary.sampleCount;
+    summaryResult.addBinaryCosts(otherSummary.binaryCosts);
+    summaryResult.lostChunks += otherSummary.lostChunks;
+    if (!summaryResult.command.contains(otherSummary.command)) {
+        summaryResult.command += QLatin1Char('\n') + otherSummary.command;
+    }
+}
+
+void ParsedInput::calculateLostIntervals()
+{
+    // lost events that are less than 100ms apart are reported as one time range
+    summaryResult.lostIntervals = SummaryData::mergeLostEvents(lostTimes, 100000000);
+}
@@ -0,0 +1,80 @@
+/*
+  parsedinput.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <QVector>
+
+#include "frametable.h"
+#include "samplestore.h"
+#include "sourcecosttable.h"
+#include "stacktable.h"
+#include "summarydata.h"
+#include "threadtable.h"
+#include "timebuckettree.h"
+
+/**
+ * The finalized data of a single input file, before the trees are built from it.
+ *
+ * When multiple files are opened, the data of every file is parsed on its own and the data of
+ * all files then gets merged in the order the files were given, so that the ids of the merged
+ * frames and stacks do not depend on which file finished parsing first.
+ */
+struct ParsedInput
+{
+    /**
+     * Merge the finalized data of @p other, which was parsed from a later input file.
+     *
+     * The frames of the stack table are remapped into the interned frames of this input, since
+     * the ids that were used while parsing are only valid per input. The stacks of @p other
+     * are appended after the ones of this input and its samples are aligned at the start of
+     * this input.
+     */
+    void merge(const ParsedInput& other);
+
+    /**
+     * Merge the lost events into the time ranges of the summary.
+     */
+    void calculateLostIntervals();
+
+    SummaryData summaryResult;
+    // the times of the lost events, see calculateLostIntervals
+    QVector<quint64> lostTimes;
+    // the line costs indexed by file
+    SourceCostTable sourceCosts;
+    // the interned strings and frames which are referenced by the trees
+    FrameTable frameTable;
+    // the unique stacks with their frames resolved
+    StackTable stackTable;
+    // the samples per time bucket and stack, its samples are also added to sampleStore
+    TimeBucketTree timeline;
+    // all samples, with their stack
+    SampleStore sampleStore;
+    // the stack counts per thread
+    ThreadTable threadTable;
+};
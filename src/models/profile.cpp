@@ -0,0 +1,292 @@
+/*
+  profile.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "profile.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace {
+/**
+ * @return the @p counts of the stacks that are also in @p other, both sorted by the stack
+ */
+QVector<StackCount> intersectStacks(const QVector<StackCount>& counts, const QVector<StackCount>& other)
+{
+    QVector<StackCount> result;
+    auto it = other.begin();
+    for (const auto& count : counts) {
+        while (it != other.end() && it->stack < count.stack) {
+            ++it;
+        }
+        if (it == other.end()) {
+            break;
+        } else if (it->stack == count.stack) {
+            result.append(count);
+        }
+    }
+    return result;
+}
+
+/**
+ * @return the sum of the @p counts and the counts of the stacks of the @p samples, sorted by the stack
+ */
+QVector<StackCount> addSamples(const QVector<StackCount>& counts, const QVector<SampleStore::Sample>& samples)
+{
+    QVector<qint32> stacks;
+    stacks.reserve(samples.size());
+    for (const auto& sample : samples) {
+        stacks.append(sample.stack);
+    }
+    std::sort(stacks.begin(), stacks.end());
+
+    QVector<StackCount> result;
+    auto it = counts.begin();
+    for (auto stack = stacks.cbegin(); stack != stacks.cend();) {
+        const auto next = std::upper_bound(stack, stacks.cend(), *stack);
+        for (; it != counts.end() && it->stack < *stack; ++it) {
+            result.append(*it);
+        }
+        StackCount count = {*stack, quint32(next - stack)};
+        if (it != counts.end() && it->stack == *stack) {
+            count.count += it->count;
+            ++it;
+        }
+        result.append(count);
+        stack = next;
+    }
+    std::copy(it, counts.end(), std::back_inserter(result));
+    return result;
+}
+}
+
+struct Profile::Data
+{
+    FrameTable frames;
+    SummaryData summary;
+    CallTree bottomUp;
+    CallTree topDown;
+    CallTree callerCallee;
+    CallGraph callGraph;
+    StackTable stacks;
+    TimeBucketTree timeline;
+    SampleStore samples;
+    ThreadTable threads;
+    SourceCostTable sourceCosts;
+};
+
+Profile::Profile()
+    : d(std::make_shared<Data>())
+{
+}
+
+Profile::Profile(std::shared_ptr<const Data> data)
+    : d(std::move(data))
+{
+}
+
+const FrameTable& Profile::frames() const
+{
+    return d->frames;
+}
+
+const SummaryData& Profile::summary() const
+{
+    return d->summary;
+}
+
+const CallTree& Profile::bottomUp() const
+{
+    return d->bottomUp;
+}
+
+const CallTree& Profile::topDown() const
+{
+    return d->topDown;
+}
+
+const CallTree& Profile::callerCallee() const
+{
+    return d->callerCallee;
+}
+
+const CallGraph& Profile::callGraph() const
+{
+    return d->callGraph;
+}
+
+const StackTable& Profile::stacks() const
+{
+    return d->stacks;
+}
+
+const TimeBucketTree& Profile::timeline() const
+{
+    return d->timeline;
+}
+
+const SampleStore& Profile::samples() const
+{
+    return d->samples;
+}
+
+const ThreadTable& Profile::threads() const
+{
+    return d->threads;
+}
+
+const SourceCostTable& Profile::sourceCosts() const
+{
+    return d->sourceCosts;
+}
+
+Profile Profile::withSummary(const FrameTable& frames, const SummaryData& summary) const
+{
+    // the results are implicitly shared, so the copy does not duplicate them
+    auto data = std::make_shared<Data>(*d);
+    data->frames = frames;
+    data->summary = summary;
+    return Profile(std::move(data));
+}
+
+Profile Profile::withBottomUp(const CallTree& bottomUp) const
+{
+    auto data = std::make_shared<Data>(*d);
+    data->bottomUp = bottomUp;
+    return Profile(std::move(data));
+}
+
+Profile Profile::withTopDown(const CallTree& topDown) const
+{
+    auto data = std::make_shared<Data>(*d);
+    data->topDown = topDown;
+    return Profile(std::move(data));
+}
+
+Profile Profile::withCallerCallee(const CallTree& callerCallee, const CallGraph& callGraph) const
+{
+    auto data = std::make_shared<Data>(*d);
+    data->callerCallee = callerCallee;
+    data->callGraph = callGraph;
+    return Profile(std::move(data));
+}
+
+Profile Profile::withStacks(const StackTable& stacks) const
+{
+    auto data = std::make_shared<Data>(*d);
+    data->stacks = stacks;
+    return Profile(std::move(data));
+}
+
+Profile Profile::withTimeline(const TimeBucketTree& timeline) const
+{
+    auto data = std::make_shared<Data>(*d);
+    data->timeline = timeline;
+    return Profile(std::move(data));
+}
+
+Profile Profile::withSamples(const SampleStore& samples) const
+{
+    auto data = std::make_shared<Data>(*d);
+    data->samples = samples;
+    return Profile(std::move(data));
+}
+
+Profile Profile::withThreads(const ThreadTable& threads) const
+{
+    auto data = std::make_shared<Data>(*d);
+    data->threads = threads;
+    return Profile(std::move(data));
+}
+
+Profile Profile::withSourceCosts(const SourceCostTable& sourceCosts) const
+{
+    auto data = std::make_shared<Data>(*d);
+    data->sourceCosts = sourceCosts;
+    return Profile(std::move(data));
+}
+
+QVector<StackCount> Profile::timeRangeCounts(quint64 startTime, quint64 endTime) const
+{
+    if (d->samples.size() == 0) {
+        return d->timeline.stackCounts(startTime, endTime);
+    }
+
+    // the buckets inside of the range come from the timeline, only the samples in the
+    // buckets at its edges need to be scanned
+    const auto bucketSize = d->timeline.bucketSize();
+    const auto innerStart = (startTime + bucketSize - 1) / bucketSize * bucketSize;
+    const auto innerEnd = endTime == std::numeric_limits<quint64>::max()
+        ? endTime : (endTime + 1) / bucketSize * bucketSize;
+    if (innerStart >= innerEnd) {
+        return addSamples({}, d->samples.samples(startTime, endTime));
+    }
+    auto counts = d->timeline.stackCounts(innerStart, innerEnd - 1);
+    if (startTime < innerStart) {
+        counts = addSamples(counts, d->samples.samples(startTime, innerStart - 1));
+    }
+    if (innerEnd <= endTime && innerEnd != std::numeric_limits<quint64>::max()) {
+        counts = addSamples(counts, d->samples.samples(innerEnd, endTime));
+    }
+    return counts;
+}
+
+Profile Profile::filtered(const StackFilter& filter) const
+{
+    CallTree bottomUp;
+    CallTree topDown;
+    const auto stacks = d->stacks.filterStacks(filter);
+    if (!filter.hasTimeRange() && filter.threads.isEmpty()) {
+        for (auto stack : stacks) {
+            d->stacks.addToBottomUp(&bottomUp, stack);
+            d->stacks.addToTopDown(&topDown, stack);
+        }
+        return withBottomUp(bottomUp).withTopDown(topDown);
+    }
+
+    QVector<StackCount> counts;
+    if (filter.hasTimeRange()) {
+        counts = timeRangeCounts(filter.startTime, filter.endTime);
+    }
+    if (!filter.threads.isEmpty()) {
+        const auto threadCounts = d->threads.stackCounts(filter.threads);
+        counts = filter.hasTimeRange() ? intersectStacks(counts, threadCounts) : threadCounts;
+    }
+
+    // both are sorted by the stack, so only the stacks in both need to be added
+    auto stack = stacks.begin();
+    for (const auto& count : counts) {
+        stack = std::lower_bound(stack, stacks.end(), count.stack);
+        if (stack == stacks.end()) {
+            break;
+        } else if (*stack == count.stack) {
+            d->stacks.addToBottomUp(&bottomUp, count.stack, count.count);
+            d->stacks.addToTopDown(&topDown, count.stack, count.count);
+        }
+    }
+    return withBottomUp(bottomUp).withTopDown(topDown);
+}
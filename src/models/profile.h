@@ -0,0 +1,101 @@
+/*
+  profile.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QMetaType>
+
+#include <memory>
+
+#include "callgraph.h"
+#include "calltree.h"
+#include "frametable.h"
+#include "samplestore.h"
+#include "sourcecosttable.h"
+#include "stacktable.h"
+#include "summarydata.h"
+#include "threadtable.h"
+#include "timebuckettree.h"
+
+/**
+ * The immutable results of parsing a profile, which are shared by all views and background jobs.
+ *
+ * The results get built concurrently, so a new profile is published whenever one of them
+ * is available. It shares all results of the previously published profile, copying a
+ * profile only increments a reference count.
+ */
+class Profile
+{
+public:
+    Profile();
+
+    const FrameTable& frames() const;
+    const SummaryData& summary() const;
+    const CallTree& bottomUp() const;
+    const CallTree& topDown() const;
+    const CallTree& callerCallee() const;
+    const CallGraph& callGraph() const;
+    const StackTable& stacks() const;
+    const TimeBucketTree& timeline() const;
+    const SampleStore& samples() const;
+    const ThreadTable& threads() const;
+    const SourceCostTable& sourceCosts() const;
+
+    /**
+     * @return a profile with the results of this one and the given additional results
+     */
+    Profile withSummary(const FrameTable& frames, const SummaryData& summary) const;
+    Profile withBottomUp(const CallTree& bottomUp) const;
+    Profile withTopDown(const CallTree& topDown) const;
+    Profile withCallerCallee(const CallTree& callerCallee, const CallGraph& callGraph) const;
+    Profile withStacks(const StackTable& stacks) const;
+    Profile withTimeline(const TimeBucketTree& timeline) const;
+    Profile withSamples(const SampleStore& samples) const;
+    Profile withThreads(const ThreadTable& threads) const;
+    Profile withSourceCosts(const SourceCostTable& sourceCosts) const;
+
+    /**
+     * @return a profile with the bottom-up and top-down trees of the stacks that pass the @p filter
+     *
+     * When the filter has a time range or selects threads, the samples outside of the range
+     * and the ones of other threads are left out as well.
+     * The caller-callee data is not filtered.
+     */
+    Profile filtered(const StackFilter& filter) const;
+
+private:
+    struct Data;
+    explicit Profile(std::shared_ptr<const Data> data);
+
+    // the exact counts of the stacks with samples in the time range, sorted by the stack
+    QVector<StackCount> timeRangeCounts(quint64 startTime, quint64 endTime) const;
+
+    std::shared_ptr<const Data> d;
+};
+
+Q_DECLARE_METATYPE(Profile)
+Q_DECLARE_TYPEINFO(Profile, Q_MOVABLE_TYPE);
@@ -0,0 +1,189 @@
+/*
+  samplestore.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "samplestore.h"
+
+#include <algorithm>
+
+namespace {
+/**
+ * Append @p value in groups of seven bits, the highest bit of a byte marks that more follow.
+ */
+void writeVarint(QByteArray* data, quint64 value)
+{
+    while (value >= 0x80) {
+        data->append(char(value | 0x80));
+        value >>= 7;
+    }
+    data->append(char(value));
+}
+
+quint64 readVarint(const char** data)
+{
+    quint64 value = 0;
+    int shift = 0;
+    quint8 byte = 0;
+    do {
+        byte = quint8(*(*data)++);
+        value |= quint64(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+// time deltas are small in both directions, zigzag encoding keeps them small when unsigned
+void writeSignedVarint(QByteArray* data, qint64 value)
+{
+    writeVarint(data, (quint64(value) << 1) ^ quint64(value >> 63));
+}
+
+qint64 readSignedVarint(const char** data)
+{
+    const auto value = readVarint(data);
+    return qint64(value >> 1) ^ -qint64(value & 1);
+}
+}
+
+SampleStore::SampleStore() = default;
+
+int SampleStore::size() const
+{
+    return m_size;
+}
+
+int SampleStore::blockCount() const
+{
+    return m_blocks.size();
+}
+
+int SampleStore::byteSize() const
+{
+    int size = 0;
+    for (const auto& block : m_blocks) {
+        size += block.times.size() + block.threads.size() + block.stacks.size() + block.attributes.size()
+            + int(sizeof(qint32)) * (block.stackValues.size() + block.attributeValues.size());
+    }
+    return size;
+}
+
+quint32 SampleStore::code(QHash<qint32, quint32>* codes, QVector<qint32>* values, qint32 value)
+{
+    auto it = codes->find(value);
+    if (it == codes->end()) {
+        it = codes->insert(value, values->size());
+        values->append(value);
+    }
+    return it.value();
+}
+
+void SampleStore::addSample(const Sample& sample)
+{
+    if (m_blocks.isEmpty() || m_blocks.last().size == BlockSize) {
+        // the dictionaries of every block only hold the values in it, which keeps the codes small
+        m_blocks.append({});
+        m_stackCodes.clear();
+        m_attributeCodes.clear();
+    }
+    auto& block = m_blocks.last();
+
+    // the first delta of a block is relative to zero, so every block can be decoded on its own
+    writeSignedVarint(&block.times, qint64(sample.time - block.lastTime));
+    block.lastTime = sample.time;
+    block.minTime = std::min(block.minTime, sample.time);
+    block.maxTime = std::max(block.maxTime, sample.time);
+
+    const auto thread = qMakePair(sample.pid, sample.tid);
+    auto it = m_threadIds.find(thread);
+    if (it == m_threadIds.end()) {
+        it = m_threadIds.insert(thread, m_threads.size());
+        m_threads.append(thread);
+    }
+    // the lowest bit of the thread marks that the attribute changed, it rarely does
+    const bool attributeChanged = block.size == 0 || sample.attribute != m_lastAttribute;
+    writeVarint(&block.threads, (quint64(it.value()) << 1) | (attributeChanged ? 1 : 0));
+    writeVarint(&block.stacks, code(&m_stackCodes, &block.stackValues, sample.stack));
+    if (attributeChanged) {
+        writeVarint(&block.attributes, code(&m_attributeCodes, &block.attributeValues, sample.attribute));
+        m_lastAttribute = sample.attribute;
+    }
+
+    ++block.size;
+    ++m_size;
+}
+
+void SampleStore::merge(const SampleStore& other, qint32 stackOffset, qint64 timeOffset)
+{
+    for (auto sample : other.samples()) {
+        sample.time += timeOffset;
+        sample.stack += stackOffset;
+        addSample(sample);
+    }
+}
+
+QVector<SampleStore::Sample> SampleStore::samples(quint64 startTime, quint64 endTime) const
+{
+    QVector<Sample> samples;
+    for (const auto& block : m_blocks) {
+        if (block.maxTime < startTime || block.minTime > endTime) {
+            continue;
+        }
+        decode(block, &samples, startTime, endTime);
+    }
+    return samples;
+}
+
+void SampleStore::decode(const Block& block, QVector<Sample>* samples, quint64 startTime, quint64 endTime) const
+{
+    auto times = block.times.constData();
+    auto threads = block.threads.constData();
+    auto stacks = block.stacks.constData();
+    auto attributes = block.attributes.constData();
+    const bool allSamples = startTime <= block.minTime && block.maxTime <= endTime;
+    if (allSamples) {
+        samples->reserve(samples->size() + block.size);
+    }
+
+    quint64 time = 0;
+    qint32 attribute = 0;
+    for (int i = 0; i < block.size; ++i) {
+        Sample sample;
+        time += readSignedVarint(&times);
+        sample.time = time;
+        const auto threadCode = readVarint(&threads);
+        const auto& thread = m_threads.at(threadCode >> 1);
+        sample.pid = thread.first;
+        sample.tid = thread.second;
+        sample.stack = block.stackValues.at(readVarint(&stacks));
+        if (threadCode & 1) {
+            attribute = block.attributeValues.at(readVarint(&attributes));
+        }
+        sample.attribute = attribute;
+        if (allSamples || (startTime <= time && time <= endTime)) {
+            samples->append(sample);
+        }
+    }
+}
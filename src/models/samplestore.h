@@ -0,0 +1,123 @@
+/*
+  samplestore.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QMetaType>
+#include <QVector>
+
+#include <limits>
+
+/**
+ * All samples of a profile, so that they can still be analyzed after they were aggregated
+ * into the trees.
+ *
+ * The samples are stored column by column in blocks of BlockSize samples. The times are
+ * delta-encoded and the threads, stacks and attributes are coded into indices of dictionaries.
+ * The attribute of a sample is only stored when it differs from the one of the previous sample.
+ * All values are stored as variable-length integers, which keeps a sample at about five bytes
+ * with the usual sampling intervals of a millisecond. Every block knows the time range of its
+ * samples, so that scans over a time range skip all blocks outside of it.
+ *
+ * Profile::filtered uses the samples for the edges of a time range that only partially
+ * cover a bucket of the TimeBucketTree.
+ */
+class SampleStore
+{
+public:
+    enum : int { BlockSize = 4096 };
+
+    struct Sample
+    {
+        quint64 time = 0;
+        quint32 pid = 0;
+        quint32 tid = 0;
+        // the index into the StackTable of the profile
+        qint32 stack = -1;
+        qint32 attribute = 0;
+    };
+
+    SampleStore();
+
+    int size() const;
+    int blockCount() const;
+    // the number of bytes that encode the samples
+    int byteSize() const;
+
+    /**
+     * Add a @p sample, the samples should be added roughly in the order of their time.
+     */
+    void addSample(const Sample& sample);
+
+    /**
+     * Add all samples of @p other, their stacks are offset by @p stackOffset and their
+     * times by @p timeOffset.
+     */
+    void merge(const SampleStore& other, qint32 stackOffset, qint64 timeOffset);
+
+    /**
+     * @return the samples in the time range [@p startTime, @p endTime], in the order they were added
+     */
+    QVector<Sample> samples(quint64 startTime = 0,
+                            quint64 endTime = std::numeric_limits<quint64>::max()) const;
+
+private:
+    struct Block
+    {
+        int size = 0;
+        quint64 minTime = std::numeric_limits<quint64>::max();
+        quint64 maxTime = 0;
+        quint64 lastTime = 0;
+        // the columns of the block
+        QByteArray times;
+        QByteArray threads;
+        QByteArray stacks;
+        QByteArray attributes;
+        // the values of the codes in the stack and attribute columns
+        QVector<qint32> stackValues;
+        QVector<qint32> attributeValues;
+    };
+
+    static quint32 code(QHash<qint32, quint32>* codes, QVector<qint32>* values, qint32 value);
+
+    void decode(const Block& block, QVector<Sample>* samples, quint64 startTime, quint64 endTime) const;
+
+    QVector<Block> m_blocks;
+    int m_size = 0;
+    // the pid and tid of every dictionary index of the thread column
+    QVector<QPair<quint32, quint32>> m_threads;
+    QHash<QPair<quint32, quint32>, quint32> m_threadIds;
+    // the codes of the stacks and attributes in the last block
+    QHash<qint32, quint32> m_stackCodes;
+    QHash<qint32, quint32> m_attributeCodes;
+    qint32 m_lastAttribute = 0;
+};
+
+Q_DECLARE_METATYPE(SampleStore)
+Q_DECLARE_TYPEINFO(SampleStore, Q_MOVABLE_TYPE);
@@ -0,0 +1,170 @@
+/*
+  sourcecodemodel.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sourcecodemodel.h"
+
+#include <algorithm>
+
+SourceCodeModel::SourceCodeModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+SourceCodeModel::~SourceCodeModel() = default;
+
+int SourceCodeModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : NUM_COLUMNS;
+}
+
+int SourceCodeModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : std::max(m_lineOffsets.size() - 1, 0);
+}
+
+QVariant SourceCodeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return {};
+    }
+
+    switch (static_cast<Columns>(section)) {
+        case LineNumber:
+            return tr("Line");
+        case SelfCost:
+            return tr("Self Cost");
+        case InclusiveCost:
+            return tr("Inclusive Cost");
+        case Code:
+            return tr("Code");
+        case NUM_COLUMNS:
+            // fall-through
+            break;
+    }
+
+    return {};
+}
+
+QVariant SourceCodeModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return {};
+    }
+
+    if (role == Qt::DisplayRole || role == SortRole) {
+        const auto cost = lineCost(index.row());
+        switch (static_cast<Columns>(index.column())) {
+            case LineNumber:
+                return index.row() + 1;
+            case SelfCost:
+                // lines without samples are left blank, so that the hot ones stand out
+                if (cost) {
+                    return cost->selfCost;
+                }
+                return role == SortRole ? QVariant(0) : QVariant();
+            case InclusiveCost:
+                if (cost) {
+                    return cost->inclusiveCost;
+                }
+                return role == SortRole ? QVariant(0) : QVariant();
+            case Code:
+                return lineText(index.row());
+            case NUM_COLUMNS:
+                // do nothing
+                break;
+        }
+    }
+
+    return {};
+}
+
+bool SourceCodeModel::setSource(const QString& file, const QVector<LineCost>& lineCosts)
+{
+    beginResetModel();
+    if (m_file.isOpen()) {
+        // unmaps the previous file as well
+        m_file.close();
+    }
+    m_data = nullptr;
+    m_lineOffsets.clear();
+    m_lineCosts = lineCosts;
+
+    m_file.setFileName(file);
+    if (m_file.open(QIODevice::ReadOnly)) {
+        const auto size = m_file.size();
+        // empty files cannot be mapped
+        m_data = size ? reinterpret_cast<const char*>(m_file.map(0, size)) : "";
+        if (m_data) {
+            m_lineOffsets.append(0);
+            for (auto it = m_data, end = m_data + size; it != end;) {
+                it = std::find(it, end, '\n');
+                if (it != end) {
+                    ++it;
+                }
+                m_lineOffsets.append(it - m_data);
+            }
+            if (m_lineOffsets.size() == 1) {
+                m_lineOffsets.clear();
+            }
+        }
+    }
+    endResetModel();
+    return m_data != nullptr;
+}
+
+QString SourceCodeModel::file() const
+{
+    return m_file.fileName();
+}
+
+int SourceCodeModel::rowForLine(int line) const
+{
+    return std::min(std::max(line - 1, 0), rowCount() - 1);
+}
+
+QString SourceCodeModel::lineText(int row) const
+{
+    const auto begin = m_lineOffsets.at(row);
+    auto end = m_lineOffsets.at(row + 1);
+    while (end > begin && (m_data[end - 1] == '\n' || m_data[end - 1] == '\r')) {
+        --end;
+    }
+    return QString::fromUtf8(m_data + begin, int(end - begin));
+}
+
+const LineCost* SourceCodeModel::lineCost(int row) const
+{
+    const auto line = row + 1;
+    auto it = std::lower_bound(m_lineCosts.begin(), m_lineCosts.end(), line,
+                               [](const LineCost& cost, int value) {
+                                   return cost.line < value;
+                               });
+    if (it == m_lineCosts.end() || it->line != line) {
+        return nullptr;
+    }
+    return &*it;
+}
@@ -0,0 +1,88 @@
+/*
+  sourcecodemodel.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QFile>
+
+#include "sourcecosttable.h"
+
+/**
+ * The lines of a source file, annotated with their cost.
+ *
+ * The file is memory-mapped instead of read, only the lines that get displayed
+ * are decoded.
+ */
+class SourceCodeModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    SourceCodeModel(QObject* parent = nullptr);
+    ~SourceCodeModel();
+
+    enum Columns {
+        LineNumber = 0,
+        SelfCost,
+        InclusiveCost,
+        Code,
+        NUM_COLUMNS
+    };
+
+    enum Roles {
+        SortRole = Qt::UserRole
+    };
+
+    int columnCount(const QModelIndex& parent = {}) const override;
+    int rowCount(const QModelIndex& parent = {}) const override;
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+
+    /**
+     * Show the source @p file, with the @p lineCosts sorted by the line.
+     *
+     * @return false when the file could not be mapped, the model is empty then
+     */
+    bool setSource(const QString& file, const QVector<LineCost>& lineCosts);
+    QString file() const;
+
+    /**
+     * @return the row of the line with the number @p line, which starts at one
+     */
+    int rowForLine(int line) const;
+
+private:
+    QString lineText(int row) const;
+    const LineCost* lineCost(int row) const;
+
+    QFile m_file;
+    const char* m_data = nullptr;
+    // the offsets at which the lines start in m_data, followed by the end of the data
+    QVector<qint64> m_lineOffsets;
+    QVector<LineCost> m_lineCosts;
+};
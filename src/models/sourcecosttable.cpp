@@ -0,0 +1,79 @@
+/*
+  sourcecosttable.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sourcecosttable.h"
+
+#include <algorithm>
+
+SourceCostTable::SourceCostTable() = default;
+
+bool SourceCostTable::isEmpty() const
+{
+    return m_files.isEmpty();
+}
+
+QStringList SourceCostTable::files() const
+{
+    return m_files.keys();
+}
+
+QVector<LineCost> SourceCostTable::lineCosts(const QString& file) const
+{
+    return m_files.value(file);
+}
+
+void SourceCostTable::addLineCosts(const QString& file, const QVector<LineCost>& costs)
+{
+    auto& lines = m_files[file];
+    lines += costs;
+    std::sort(lines.begin(), lines.end(), [](const LineCost& lhs, const LineCost& rhs) {
+        return lhs.line < rhs.line;
+    });
+
+    // sum up the costs of the same line
+    auto last = lines.begin();
+    for (auto it = lines.begin(); it != lines.end(); ++it) {
+        if (it == last) {
+            continue;
+        } else if (it->line == last->line) {
+            last->selfCost += it->selfCost;
+            last->inclusiveCost += it->inclusiveCost;
+        } else {
+            *(++last) = *it;
+        }
+    }
+    if (!lines.isEmpty()) {
+        lines.resize(std::distance(lines.begin(), last) + 1);
+    }
+}
+
+void SourceCostTable::merge(const SourceCostTable& other)
+{
+    for (auto it = other.m_files.begin(), end = other.m_files.end(); it != end; ++it) {
+        addLineCosts(it.key(), it.value());
+    }
+}
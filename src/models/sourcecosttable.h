@@ -0,0 +1,80 @@
+/*
+  sourcecosttable.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QMetaType>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * The samples of a profile that hit a line of a source file.
+ */
+struct LineCost
+{
+    qint32 line = -1;
+    // the samples whose innermost frame is on the line
+    quint64 selfCost = 0;
+    // the samples with any frame on the line, each only counted once
+    quint64 inclusiveCost = 0;
+};
+
+Q_DECLARE_TYPEINFO(LineCost, Q_PRIMITIVE_TYPE);
+
+/**
+ * The cost of the lines of all source files of a profile, indexed by file.
+ */
+class SourceCostTable
+{
+public:
+    SourceCostTable();
+
+    bool isEmpty() const;
+    QStringList files() const;
+
+    /**
+     * @return the costs of the lines of the @p file, sorted by the line
+     */
+    QVector<LineCost> lineCosts(const QString& file) const;
+
+    /**
+     * Add the @p costs of lines of the @p file, in any order.
+     */
+    void addLineCosts(const QString& file, const QVector<LineCost>& costs);
+
+    /**
+     * Add the costs of all lines of the @p other table.
+     */
+    void merge(const SourceCostTable& other);
+
+private:
+    QHash<QString, QVector<LineCost>> m_files;
+};
+
+Q_DECLARE_METATYPE(SourceCostTable)
+Q_DECLARE_TYPEINFO(SourceCostTable, Q_MOVABLE_TYPE);
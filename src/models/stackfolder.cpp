@@ -0,0 +1,165 @@
+/*
+  stackfolder.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stackfolder.h"
+
+#include <QVarLengthArray>
+
+#include <algorithm>
+
+Frame aggregateFrame(Frame frame, FrameAggregation aggregation)
+{
+    if (aggregation >= FrameAggregation::SourceLine) {
+        frame.address = 0;
+        frame.column = -1;
+    }
+    if (aggregation >= FrameAggregation::Function) {
+        frame.line = -1;
+    }
+    if (aggregation >= FrameAggregation::Binary) {
+        // the binary takes the place of the symbol in all views, its sources span many files
+        frame.symbol = frame.binary;
+        frame.file = -1;
+    }
+    return frame;
+}
+
+QBitArray findRecursiveFrames(const FrameTable& frames, const QVector<qint32>& stack)
+{
+    QBitArray recursiveFrames(stack.size());
+    // even deep recursion only has a few distinct symbols, so a linear search is fastest
+    QVarLengthArray<qint32, 64> symbols;
+    for (int i = 0; i < stack.size(); ++i) {
+        const auto symbol = frames.frame(stack.at(i)).symbol;
+        if (symbol < 0) {
+            continue;
+        }
+        if (std::find(symbols.cbegin(), symbols.cend(), symbol) != symbols.cend()) {
+            recursiveFrames.setBit(i);
+        } else {
+            symbols.append(symbol);
+        }
+    }
+    return recursiveFrames;
+}
+
+StackFolder::StackFolder(FrameTable* frames)
+    : m_frames(frames)
+{
+}
+
+void StackFolder::setAggregation(FrameAggregation aggregation)
+{
+    m_aggregation = aggregation;
+    m_foldedFrames.clear();
+}
+
+void StackFolder::setFoldingRules(const QVector<FoldingRule>& rules)
+{
+    m_foldingRules = rules;
+    m_foldedFrames.clear();
+}
+
+void StackFolder::setCollapseKernelFrames(bool collapse)
+{
+    m_collapseKernelFrames = collapse;
+    if (collapse && m_collapsedKernelFrameId == -1) {
+        Frame kernelFrame;
+        kernelFrame.symbol = m_frames->internString(QStringLiteral("[kernel]"));
+        kernelFrame.binary = kernelFrame.symbol;
+        kernelFrame.isKernel = true;
+        m_collapsedKernelFrameId = m_frames->internFrame(kernelFrame);
+    }
+}
+
+QVector<qint32> StackFolder::foldStack(const QVector<qint32>& frames)
+{
+    QVector<qint32> folded;
+    folded.reserve(frames.size());
+    // the rule that merged the last folded frame, or -1
+    int lastRule = -1;
+    for (auto resolvedFrameId : frames) {
+        const auto foldedFrame = foldFrame(resolvedFrameId);
+        const auto frameId = foldedFrame.frameId;
+        if (frameId == -1) {
+            // collapsed into its caller
+            continue;
+        }
+        if (m_collapseKernelFrames && m_frames->frame(frameId).isKernel) {
+            if (folded.isEmpty() || folded.last() != m_collapsedKernelFrameId) {
+                folded.append(m_collapsedKernelFrameId);
+            }
+            lastRule = -1;
+        } else if (foldedFrame.rule != -1 && foldedFrame.rule == lastRule) {
+            // the calls between frames that got merged by the same rule are not interesting,
+            // even when the merged frames differ in their binary
+            continue;
+        } else if (m_aggregation != FrameAggregation::Binary || folded.isEmpty() || folded.last() != frameId) {
+            // calls within a binary are not interesting when aggregating by binary
+            folded.append(frameId);
+            lastRule = foldedFrame.rule;
+        }
+    }
+    return folded;
+}
+
+StackFolder::FoldedFrame StackFolder::foldFrame(qint32 frameId)
+{
+    if (m_foldedFrames.size() <= frameId) {
+        m_foldedFrames.resize(m_frames->frameCount());
+    }
+
+    auto folded = m_foldedFrames.at(frameId);
+    if (folded.frameId == FoldedFrame::Unknown) {
+        const auto frame = m_frames->frame(frameId);
+        folded.frameId = m_frames->internFrame(aggregateFrame(frame, m_aggregation));
+        if (!m_foldingRules.isEmpty()) {
+            const auto symbol = m_frames->string(frame.symbol);
+            const auto binary = m_frames->string(frame.binary);
+            for (int i = 0; i < m_foldingRules.size(); ++i) {
+                const auto& rule = m_foldingRules.at(i);
+                if (!rule.matches(symbol, binary)) {
+                    continue;
+                }
+                if (rule.action == FoldingRule::CollapseIntoCaller) {
+                    folded.frameId = -1;
+                } else {
+                    // the merged frame keeps its binary and stays in kernel space when it was
+                    Frame mergedFrame;
+                    mergedFrame.symbol = m_frames->internString(rule.frameName);
+                    mergedFrame.binary = frame.binary;
+                    mergedFrame.isKernel = frame.isKernel;
+                    folded.frameId = m_frames->internFrame(mergedFrame);
+                    folded.rule = i;
+                }
+                break;
+            }
+        }
+        m_foldedFrames[frameId] = folded;
+    }
+    return folded;
+}
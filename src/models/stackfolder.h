@@ -0,0 +1,117 @@
+/*
+  stackfolder.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QBitArray>
+#include <QVector>
+
+#include "foldingrule.h"
+#include "frametable.h"
+
+/**
+ * The granularity at which the frames of the samples get aggregated,
+ * ordered from the finest to the coarsest one.
+ */
+enum class FrameAggregation
+{
+    // every instruction address is a separate frame
+    Address,
+    // the frames of a function are aggregated per source line
+    SourceLine,
+    // all frames of a function are aggregated, they keep the file of the function
+    Function,
+    // all frames of a binary are aggregated, consecutive ones into a single frame
+    Binary
+};
+
+/**
+ * @return the @p frame without the details that are finer than the @p aggregation,
+ *         so that all frames which only differ in them get interned as a single frame
+ */
+Frame aggregateFrame(Frame frame, FrameAggregation aggregation);
+
+/**
+ * Find the recursive calls in the @p stack, which starts with the innermost frame.
+ *
+ * Every symbol is only kept at its innermost call, so the self cost stays where it is and
+ * every function on the stack is still seen. This covers direct and indirect recursion,
+ * i.e. main > a > b > a > b > c becomes main > a > b > c. Frames without a symbol are kept.
+ *
+ * The innermost call is kept instead of the outermost one, since keeping the outermost call
+ * of main > a > b > a would attribute the self cost of a to b. The price is that a cycle can
+ * produce a call that never happened: main > a > b > a > c becomes main > b > a > c. Only the
+ * bottom-up and top-down trees are folded, the caller-callee data keeps the real calls.
+ *
+ * @return a set bit for every frame of the @p stack that gets folded
+ */
+QBitArray findRecursiveFrames(const FrameTable& frames, const QVector<qint32>& stack);
+
+/**
+ * Turns the resolved frames of a stack into the frames that are shown in the trees.
+ *
+ * The frames get aggregated, folded by the folding rules and kernel frames optionally get
+ * collapsed. Every frame is only looked at once, the result is cached per frame id.
+ */
+class StackFolder
+{
+public:
+    /**
+     * The folded frames get interned into @p frames, which has to outlive the folder.
+     */
+    explicit StackFolder(FrameTable* frames);
+
+    void setAggregation(FrameAggregation aggregation);
+    void setFoldingRules(const QVector<FoldingRule>& rules);
+    void setCollapseKernelFrames(bool collapse);
+
+    /**
+     * @return the folded frames of a stack with the resolved @p frames,
+     *         both start with the innermost frame
+     */
+    QVector<qint32> foldStack(const QVector<qint32>& frames);
+
+private:
+    struct FoldedFrame
+    {
+        enum : qint32 { Unknown = -2 };
+        // the id of the folded frame, or -1 when it gets collapsed into its caller
+        qint32 frameId = Unknown;
+        // the index of the folding rule that merged the frame, or -1
+        int rule = -1;
+    };
+
+    FoldedFrame foldFrame(qint32 frameId);
+
+    FrameTable* m_frames;
+    FrameAggregation m_aggregation = FrameAggregation::Address;
+    QVector<FoldingRule> m_foldingRules;
+    bool m_collapseKernelFrames = false;
+    qint32 m_collapsedKernelFrameId = -1;
+    // the folded frame of every frame id, see foldFrame
+    QVector<FoldedFrame> m_foldedFrames;
+};
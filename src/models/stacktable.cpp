@@ -0,0 +1,235 @@
+/*
+  stacktable.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stacktable.h"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+#include "calltree.h"
+#include "frametable.h"
+
+StackTable::StackTable()
+{
+    // the frames of every stack end where the ones of the next stack begin
+    m_frameOffsets.append(0);
+}
+
+int StackTable::size() const
+{
+    return m_counts.size();
+}
+
+int StackTable::frameCount(int stack) const
+{
+    return m_frameOffsets.at(stack + 1) - m_frameOffsets.at(stack);
+}
+
+qint32 StackTable::frameId(int stack, int index) const
+{
+    return m_frameIds.at(m_frameOffsets.at(stack) + index);
+}
+
+qint32 StackTable::processFrameId(int stack) const
+{
+    return m_processFrameIds.at(stack);
+}
+
+bool StackTable::isRecursive(int stack, int index) const
+{
+    return m_recursiveFrames.testBit(m_frameOffsets.at(stack) + index);
+}
+
+quint32 StackTable::count(int stack) const
+{
+    return m_counts.at(stack);
+}
+
+quint32 StackTable::kernelCost(int stack) const
+{
+    return m_kernelCosts.at(stack);
+}
+
+quint32 StackTable::scaledKernelCost(int stack, quint32 count) const
+{
+    const auto stackCount = this->count(stack);
+    if (count == stackCount || stackCount == 0) {
+        return kernelCost(stack);
+    }
+    return quint64(kernelCost(stack)) * count / stackCount;
+}
+
+void StackTable::addStack(const QVector<qint32>& frameIds, qint32 processFrameId, quint32 count, quint32 kernelCost,
+                          const QBitArray& recursiveFrames)
+{
+    const auto offset = m_frameIds.size();
+    m_frameIds += frameIds;
+    m_recursiveFrames.resize(m_frameIds.size());
+    for (int i = 0; i < recursiveFrames.size(); ++i) {
+        if (recursiveFrames.testBit(i)) {
+            m_recursiveFrames.setBit(offset + i);
+        }
+    }
+    m_frameOffsets.append(m_frameIds.size());
+    m_processFrameIds.append(processFrameId);
+    m_counts.append(count);
+    m_kernelCosts.append(kernelCost);
+}
+
+void StackTable::append(const StackTable& other, const QVector<qint32>& remappedIds)
+{
+    const auto frameOffset = m_frameIds.size();
+    m_frameIds.reserve(frameOffset + other.m_frameIds.size());
+    for (auto frameId : other.m_frameIds) {
+        m_frameIds.append(remappedIds.at(frameId));
+    }
+    m_recursiveFrames.resize(m_frameIds.size());
+    for (int i = 0; i < other.m_recursiveFrames.size(); ++i) {
+        if (other.m_recursiveFrames.testBit(i)) {
+            m_recursiveFrames.setBit(frameOffset + i);
+        }
+    }
+    for (int stack = 0, c = other.size(); stack < c; ++stack) {
+        m_frameOffsets.append(frameOffset + other.m_frameOffsets.at(stack + 1));
+        const auto processFrameId = other.processFrameId(stack);
+        m_processFrameIds.append(processFrameId == -1 ? -1 : remappedIds.at(processFrameId));
+    }
+    m_counts += other.m_counts;
+    m_kernelCosts += other.m_kernelCosts;
+    // the symbols need to be indexed again
+    m_symbolStacks.clear();
+}
+
+void StackTable::indexSymbols(const FrameTable& frames)
+{
+    m_symbolStacks.clear();
+    for (int stack = 0, c = size(); stack < c; ++stack) {
+        for (int i = m_frameOffsets.at(stack), end = m_frameOffsets.at(stack + 1); i < end; ++i) {
+            auto& stacks = m_symbolStacks[frames.frame(m_frameIds.at(i)).symbol];
+            // recursive symbols only get indexed once per stack
+            if (stacks.isEmpty() || stacks.last() != stack) {
+                stacks.append(stack);
+            }
+        }
+    }
+}
+
+QVector<int> StackTable::stacksWithSymbol(qint32 symbol) const
+{
+    return m_symbolStacks.value(symbol);
+}
+
+QVector<int> StackTable::filterStacks(const StackFilter& filter) const
+{
+    QVector<int> stacks;
+    if (filter.focusedSymbols.isEmpty()) {
+        stacks.resize(size());
+        std::iota(stacks.begin(), stacks.end(), 0);
+    } else {
+        stacks = stacksWithSymbol(filter.focusedSymbols.first());
+    }
+
+    QVector<int> filteredStacks;
+    auto filterBy = [&stacks, &filteredStacks, this](qint32 symbol, bool focus) {
+        const auto symbolStacks = stacksWithSymbol(symbol);
+        filteredStacks.clear();
+        if (focus) {
+            std::set_intersection(stacks.begin(), stacks.end(), symbolStacks.begin(), symbolStacks.end(),
+                                  std::back_inserter(filteredStacks));
+        } else {
+            std::set_difference(stacks.begin(), stacks.end(), symbolStacks.begin(), symbolStacks.end(),
+                                std::back_inserter(filteredStacks));
+        }
+        std::swap(stacks, filteredStacks);
+    };
+    for (int i = 1; i < filter.focusedSymbols.size(); ++i) {
+        filterBy(filter.focusedSymbols.at(i), true);
+    }
+    for (auto symbol : filter.excludedSymbols) {
+        filterBy(symbol, false);
+    }
+    return stacks;
+}
+
+void StackTable::addToBottomUp(CallTree* tree, int stack) const
+{
+    addToBottomUp(tree, stack, count(stack));
+}
+
+void StackTable::addToBottomUp(CallTree* tree, int stack, quint32 count) const
+{
+    const auto kernelCost = scaledKernelCost(stack, count);
+
+    int parent = CallTree::RootNode;
+    tree->addCost(parent, count, kernelCost);
+    if (processFrameId(stack) != -1) {
+        parent = tree->addChild(parent, processFrameId(stack));
+        tree->addCost(parent, count, kernelCost);
+    }
+
+    for (int i = m_frameOffsets.at(stack), end = m_frameOffsets.at(stack + 1); i < end; ++i) {
+        if (m_recursiveFrames.testBit(i)) {
+            continue;
+        }
+        parent = tree->addChild(parent, m_frameIds.at(i));
+        tree->addCost(parent, count, kernelCost);
+        if (i == m_frameOffsets.at(stack)) {
+            // the innermost frame
+            tree->addSelfCost(parent, count);
+        }
+    }
+}
+
+void StackTable::addToTopDown(CallTree* tree, int stack) const
+{
+    addToTopDown(tree, stack, count(stack));
+}
+
+void StackTable::addToTopDown(CallTree* tree, int stack, quint32 count) const
+{
+    const auto kernelCost = scaledKernelCost(stack, count);
+
+    int parent = CallTree::RootNode;
+    tree->addCost(parent, count, kernelCost);
+    if (processFrameId(stack) != -1) {
+        parent = tree->addChild(parent, processFrameId(stack));
+        tree->addCost(parent, count, kernelCost);
+    }
+
+    const auto begin = m_frameOffsets.at(stack);
+    for (int i = m_frameOffsets.at(stack + 1) - 1; i >= begin; --i) {
+        if (m_recursiveFrames.testBit(i)) {
+            continue;
+        }
+        parent = tree->addChild(parent, m_frameIds.at(i));
+        tree->addCost(parent, count, kernelCost);
+    }
+    if (frameCount(stack) > 0) {
+        tree->addSelfCost(parent, count);
+    }
+}
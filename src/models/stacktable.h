@@ -0,0 +1,153 @@
+/*
+  stacktable.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QBitArray>
+#include <QHash>
+#include <QMetaType>
+#include <QVector>
+
+class CallTree;
+class FrameTable;
+
+/**
+ * Restricts a profile to the stacks that contain all focused symbols and none of the excluded ones.
+ *
+ * The symbols are string ids in the frame table of the profile.
+ */
+struct StackFilter
+{
+    QVector<qint32> focusedSymbols;
+    QVector<qint32> excludedSymbols;
+    // the time range of the samples to keep, in the clock of the samples
+    quint64 startTime = 0;
+    quint64 endTime = 0;
+    // the indices of the threads in the ThreadTable to keep, all threads when empty
+    QVector<int> threads;
+
+    bool isEmpty() const
+    {
+        return focusedSymbols.isEmpty() && excludedSymbols.isEmpty() && !hasTimeRange()
+            && threads.isEmpty();
+    }
+
+    bool hasTimeRange() const
+    {
+        return endTime != 0;
+    }
+};
+
+Q_DECLARE_TYPEINFO(StackFilter, Q_MOVABLE_TYPE);
+
+/**
+ * The unique stacks of a profile with their frames resolved, which all trees get built from.
+ *
+ * The stacks can be indexed by the symbols of their frames, so that the trees for a subset
+ * of the stacks get built in time proportional to the size of the subset.
+ */
+class StackTable
+{
+public:
+    StackTable();
+
+    int size() const;
+
+    /**
+     * The frames of a stack are ordered from the innermost to the outermost one.
+     */
+    int frameCount(int stack) const;
+    qint32 frameId(int stack, int index) const;
+    // the frame of the process the stack is grouped by, or -1
+    qint32 processFrameId(int stack) const;
+    // the number of samples with this stack
+    quint32 count(int stack) const;
+    quint32 kernelCost(int stack) const;
+
+    // whether the frame is a recursive call that is left out of the trees, see findRecursiveFrames
+    bool isRecursive(int stack, int index) const;
+
+    /**
+     * The @p recursiveFrames are left out of the bottom-up and top-down trees,
+     * none of the frames are when it is empty.
+     */
+    void addStack(const QVector<qint32>& frameIds, qint32 processFrameId, quint32 count, quint32 kernelCost,
+                  const QBitArray& recursiveFrames = {});
+
+    /**
+     * Append the stacks of the @p other table, @p remappedIds maps the frame ids of the other table
+     * to the ones of this table.
+     */
+    void append(const StackTable& other, const QVector<qint32>& remappedIds);
+
+    /**
+     * Index the stacks by the symbols of their frames, which are looked up in @p frames.
+     */
+    void indexSymbols(const FrameTable& frames);
+
+    /**
+     * @return the sorted ids of the stacks with a frame of the @p symbol
+     *
+     * This requires the stacks to be indexed, see indexSymbols.
+     */
+    QVector<int> stacksWithSymbol(qint32 symbol) const;
+
+    /**
+     * @return the sorted ids of the stacks that pass the @p filter
+     *
+     * Only the stacks of the focused symbols get visited when there are any.
+     */
+    QVector<int> filterStacks(const StackFilter& filter) const;
+
+    void addToBottomUp(CallTree* tree, int stack) const;
+    void addToTopDown(CallTree* tree, int stack) const;
+
+    /**
+     * Add only @p count of the samples of the @p stack, e.g. the ones in a time range.
+     * The kernel cost of the stack is scaled down accordingly.
+     */
+    void addToBottomUp(CallTree* tree, int stack, quint32 count) const;
+    void addToTopDown(CallTree* tree, int stack, quint32 count) const;
+
+private:
+    // the share of the kernel cost of the @p stack that falls on @p count of its samples
+    quint32 scaledKernelCost(int stack, quint32 count) const;
+
+    // the frame ids of all stacks, the ones of a stack start at its entry in m_frameOffsets
+    QVector<qint32> m_frameIds;
+    QVector<int> m_frameOffsets;
+    // a set bit for every entry in m_frameIds that is a recursive call
+    QBitArray m_recursiveFrames;
+    QVector<qint32> m_processFrameIds;
+    QVector<quint32> m_counts;
+    QVector<quint32> m_kernelCosts;
+    // the sorted ids of the stacks that contain a symbol
+    QHash<qint32, QVector<int>> m_symbolStacks;
+};
+
+Q_DECLARE_METATYPE(StackTable)
+Q_DECLARE_TYPEINFO(StackTable, Q_MOVABLE_TYPE);
@@ -0,0 +1,78 @@
+/*
+  summarydata.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "summarydata.h"
+
+#include <algorithm>
+
+quint64 SummaryData::lostChunksInRange(quint64 startTime, quint64 endTime) const
+{
+    // skip all intervals that end before the range starts
+    auto it = std::lower_bound(lostIntervals.begin(), lostIntervals.end(), startTime,
+                               [](const LostInterval& interval, quint64 time) {
+                                   return interval.endTime < time;
+                               });
+    quint64 chunks = 0;
+    for (; it != lostIntervals.end() && it->startTime <= endTime; ++it) {
+        chunks += it->chunks;
+    }
+    return chunks;
+}
+
+QVector<LostInterval> SummaryData::mergeLostEvents(QVector<quint64> times, quint64 maxGap)
+{
+    std::sort(times.begin(), times.end());
+
+    QVector<LostInterval> intervals;
+    for (auto time : times) {
+        if (intervals.isEmpty() || time - intervals.last().endTime > maxGap) {
+            intervals.append({time, time, 0});
+        }
+        auto& interval = intervals.last();
+        interval.endTime = time;
+        ++interval.chunks;
+    }
+    return intervals;
+}
+
+void SummaryData::addBinaryCosts(const QVector<BinaryCost>& costs)
+{
+    for (const auto& cost : costs) {
+        auto it = std::find_if(binaryCosts.begin(), binaryCosts.end(), [&cost](const BinaryCost& binaryCost) {
+            return binaryCost.binary == cost.binary;
+        });
+        if (it == binaryCosts.end()) {
+            binaryCosts.append(cost);
+        } else {
+            it->selfCost += cost.selfCost;
+            it->inclusiveCost += cost.inclusiveCost;
+        }
+    }
+    std::stable_sort(binaryCosts.begin(), binaryCosts.end(), [](const BinaryCost& lhs, const BinaryCost& rhs) {
+        return lhs.inclusiveCost > rhs.inclusiveCost;
+    });
+}
@@ -28,15 +28,69 @@
 #pragma once
 
 #include <QTypeInfo>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * A time range in which the kernel reported lost events.
+ *
+ * Samples recorded in this range are incomplete, i.e. the data is unreliable.
+ */
+struct LostInterval
+{
+    quint64 startTime = 0;
+    quint64 endTime = 0;
+    quint64 chunks = 0;
+};
+
+Q_DECLARE_TYPEINFO(LostInterval, Q_PRIMITIVE_TYPE);
+
+/**
+ * The samples of a profile that hit a binary.
+ */
+struct BinaryCost
+{
+    QString binary;
+    // the samples whose innermost frame is in the binary
+    quint64 selfCost = 0;
+    // the samples with any frame in the binary, each only counted once
+    quint64 inclusiveCost = 0;
+};
+
+Q_DECLARE_TYPEINFO(BinaryCost, Q_MOVABLE_TYPE);
 
 struct SummaryData
 {
+    quint64 applicationStartTime = 0;
     quint64 applicationRunningTime = 0;
     quint32 threadCount = 0;
     quint32 processCount = 0;
     quint64 sampleCount = 0;
     QString command;
     quint64 lostChunks = 0;
+    // sorted by time and non-overlapping
+    QVector<LostInterval> lostIntervals;
+    // the folding rules that were applied while parsing
+    QStringList foldingRules;
+    // sorted by the inclusive cost, highest first
+    QVector<BinaryCost> binaryCosts;
+
+    /**
+     * @return the number of lost chunks in the time range [@p startTime, @p endTime]
+     */
+    quint64 lostChunksInRange(quint64 startTime, quint64 endTime) const;
+
+    /**
+     * Sort the @p times of lost events and merge all events that are
+     * at most @p maxGap nanoseconds apart into a single interval.
+     */
+    static QVector<LostInterval> mergeLostEvents(QVector<quint64> times, quint64 maxGap);
+
+    /**
+     * Add the @p costs to the ones of the same binary in binaryCosts, which are then sorted again.
+     */
+    void addBinaryCosts(const QVector<BinaryCost>& costs);
 };
 
 Q_DECLARE_METATYPE(SummaryData)
@@ -0,0 +1,101 @@
+/*
+  threadtable.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "threadtable.h"
+
+#include <algorithm>
+
+ThreadTable::ThreadTable() = default;
+
+int ThreadTable::size() const
+{
+    return m_threads.size();
+}
+
+quint32 ThreadTable::pid(int thread) const
+{
+    return m_threads.at(thread).pid;
+}
+
+quint32 ThreadTable::tid(int thread) const
+{
+    return m_threads.at(thread).tid;
+}
+
+QString ThreadTable::name(int thread) const
+{
+    return m_threads.at(thread).name;
+}
+
+quint64 ThreadTable::sampleCount(int thread) const
+{
+    return m_threads.at(thread).sampleCount;
+}
+
+int ThreadTable::addThread(quint32 pid, quint32 tid, const QString& name)
+{
+    m_threads.append({pid, tid, name, 0, {}});
+    return m_threads.size() - 1;
+}
+
+void ThreadTable::addStack(int thread, qint32 stack, quint32 count)
+{
+    auto& data = m_threads[thread];
+    Q_ASSERT(data.stackCounts.isEmpty() || data.stackCounts.last().stack < stack);
+    data.stackCounts.append({stack, count});
+    data.sampleCount += count;
+}
+
+void ThreadTable::append(const ThreadTable& other, qint32 stackOffset)
+{
+    // the threads of different inputs are not related, even when their ids are the same
+    m_threads.reserve(m_threads.size() + other.m_threads.size());
+    for (auto thread : other.m_threads) {
+        for (auto& count : thread.stackCounts) {
+            count.stack += stackOffset;
+        }
+        m_threads.append(thread);
+    }
+}
+
+QVector<StackCount> ThreadTable::stackCounts(int thread) const
+{
+    return m_threads.at(thread).stackCounts;
+}
+
+QVector<StackCount> ThreadTable::stackCounts(const QVector<int>& threads) const
+{
+    QVector<StackCount> counts;
+    for (auto thread : threads) {
+        counts += m_threads.at(thread).stackCounts;
+    }
+    // no stack is shared between threads, so the counts only need to be sorted
+    std::sort(counts.begin(), counts.end(), [](const StackCount& lhs, const StackCount& rhs) {
+        return lhs.stack < rhs.stack;
+    });
+    return counts;
+}
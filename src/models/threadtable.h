@@ -0,0 +1,94 @@
+/*
+  threadtable.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+#include "timebuckettree.h"
+
+/**
+ * The threads of a profile with the counts of their stacks.
+ *
+ * Every stack of the StackTable belongs to exactly one thread, so the trees of a selection
+ * of threads get built from the merged stack counts of the selected threads alone.
+ */
+class ThreadTable
+{
+public:
+    ThreadTable();
+
+    int size() const;
+
+    quint32 pid(int thread) const;
+    quint32 tid(int thread) const;
+    QString name(int thread) const;
+    // the number of samples of the thread
+    quint64 sampleCount(int thread) const;
+
+    /**
+     * @return the index of the new thread
+     */
+    int addThread(quint32 pid, quint32 tid, const QString& name);
+
+    /**
+     * Add the samples of a @p stack to the @p thread, the stacks have to be added in ascending order.
+     */
+    void addStack(int thread, qint32 stack, quint32 count);
+
+    /**
+     * Append the threads of the @p other table, their stacks are offset by @p stackOffset.
+     */
+    void append(const ThreadTable& other, qint32 stackOffset);
+
+    /**
+     * @return the stack counts of the @p thread, sorted by the stack
+     */
+    QVector<StackCount> stackCounts(int thread) const;
+
+    /**
+     * @return the merged stack counts of all @p threads, sorted by the stack
+     */
+    QVector<StackCount> stackCounts(const QVector<int>& threads) const;
+
+private:
+    struct Thread
+    {
+        quint32 pid;
+        quint32 tid;
+        QString name;
+        quint64 sampleCount;
+        QVector<StackCount> stackCounts;
+    };
+
+    QVector<Thread> m_threads;
+};
+
+Q_DECLARE_METATYPE(ThreadTable)
+Q_DECLARE_TYPEINFO(ThreadTable, Q_MOVABLE_TYPE);
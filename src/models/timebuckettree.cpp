@@ -0,0 +1,170 @@
+/*
+  timebuckettree.cpp
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "timebuckettree.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+/**
+ * Append the counts of the sorted ranges [first1, last1) and [first2, last2) to @p result,
+ * the counts of the stacks in both ranges are summed up.
+ */
+void mergeCounts(const StackCount* first1, const StackCount* last1,
+                 const StackCount* first2, const StackCount* last2,
+                 QVector<StackCount>* result)
+{
+    while (first1 != last1 && first2 != last2) {
+        if (first1->stack < first2->stack) {
+            result->append(*first1++);
+        } else if (first2->stack < first1->stack) {
+            result->append(*first2++);
+        } else {
+            result->append({first1->stack, first1->count + first2->count});
+            ++first1;
+            ++first2;
+        }
+    }
+    for (; first1 != last1; ++first1) {
+        result->append(*first1);
+    }
+    for (; first2 != last2; ++first2) {
+        result->append(*first2);
+    }
+}
+}
+
+TimeBucketTree::TimeBucketTree(quint64 bucketSize)
+    : m_bucketSize(bucketSize)
+{
+}
+
+quint64 TimeBucketTree::bucketSize() const
+{
+    return m_bucketSize;
+}
+
+void TimeBucketTree::addSample(quint64 time, qint32 stack)
+{
+    ++m_sampleCounts[qMakePair(time / m_bucketSize, stack)];
+}
+
+void TimeBucketTree::build()
+{
+    m_counts.clear();
+    m_nodeOffsets.clear();
+    if (m_sampleCounts.isEmpty()) {
+        m_bucketCount = 0;
+        return;
+    }
+
+    auto firstBucket = std::numeric_limits<quint64>::max();
+    quint64 lastBucket = 0;
+    for (auto it = m_sampleCounts.constBegin(); it != m_sampleCounts.constEnd(); ++it) {
+        firstBucket = std::min(firstBucket, it.key().first);
+        lastBucket = std::max(lastBucket, it.key().first);
+    }
+    // the buckets get coarser by a whole factor, so a bucket of the coarser size still
+    // contains exactly the samples in its time range
+    const auto bucketFactor = (lastBucket - firstBucket) / MaxBucketCount + 1;
+    m_bucketSize *= bucketFactor;
+    m_firstBucket = firstBucket / bucketFactor;
+    m_bucketCount = int(lastBucket / bucketFactor - m_firstBucket + 1);
+
+    QVector<Sample> samples;
+    samples.reserve(m_sampleCounts.size());
+    for (auto it = m_sampleCounts.constBegin(); it != m_sampleCounts.constEnd(); ++it) {
+        samples.append({it.key().first / bucketFactor, it.key().second, it.value()});
+    }
+    m_sampleCounts.clear();
+    m_sampleCounts.squeeze();
+    std::sort(samples.begin(), samples.end(), [](const Sample& lhs, const Sample& rhs) {
+        return lhs.bucket < rhs.bucket || (lhs.bucket == rhs.bucket && lhs.stack < rhs.stack);
+    });
+
+    // the parents are built from their children, so the nodes are built in reverse order
+    // and only get stored in the order of their index afterwards
+    QVector<QVector<StackCount>> nodes(2 * m_bucketCount);
+    for (const auto& sample : samples) {
+        auto& leaf = nodes[m_bucketCount + int(sample.bucket - m_firstBucket)];
+        if (!leaf.isEmpty() && leaf.last().stack == sample.stack) {
+            leaf.last().count += sample.count;
+        } else {
+            leaf.append({sample.stack, sample.count});
+        }
+    }
+
+    for (int node = m_bucketCount - 1; node > 0; --node) {
+        const auto& left = nodes.at(2 * node);
+        const auto& right = nodes.at(2 * node + 1);
+        auto& parent = nodes[node];
+        parent.reserve(std::max(left.size(), right.size()));
+        mergeCounts(left.constData(), left.constData() + left.size(),
+                    right.constData(), right.constData() + right.size(), &parent);
+    }
+
+    m_nodeOffsets.reserve(nodes.size() + 1);
+    for (const auto& node : nodes) {
+        m_nodeOffsets.append(m_counts.size());
+        m_counts += node;
+    }
+    m_nodeOffsets.append(m_counts.size());
+}
+
+QVector<StackCount> TimeBucketTree::stackCounts(quint64 startTime, quint64 endTime) const
+{
+    QVector<StackCount> counts;
+    const auto startBucket = std::max(startTime / m_bucketSize, m_firstBucket);
+    const auto endBucket = std::min(endTime / m_bucketSize, m_firstBucket + m_bucketCount - 1);
+    if (m_bucketCount == 0 || startBucket > endBucket) {
+        return counts;
+    }
+
+    // collect the nodes that cover the range [begin, end) bottom-up
+    QVector<StackCount> merged;
+    auto addNode = [this, &counts, &merged](int node) {
+        const auto first = m_counts.constData() + m_nodeOffsets.at(node);
+        const auto last = m_counts.constData() + m_nodeOffsets.at(node + 1);
+        merged.clear();
+        mergeCounts(counts.constData(), counts.constData() + counts.size(), first, last, &merged);
+        std::swap(counts, merged);
+    };
+    int begin = m_bucketCount + int(startBucket - m_firstBucket);
+    int end = m_bucketCount + int(endBucket - m_firstBucket) + 1;
+    while (begin < end) {
+        if (begin & 1) {
+            addNode(begin++);
+        }
+        if (end & 1) {
+            addNode(--end);
+        }
+        begin /= 2;
+        end /= 2;
+    }
+    return counts;
+}
@@ -0,0 +1,108 @@
+/*
+  timebuckettree.h
+
+  This file is part of Hotspot, the Qt GUI for performance analysis.
+
+  Copyright (C) 2017 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+  Author: Milian Wolff <milian.wolff@kdab.com>
+
+  Licensees holding valid commercial KDAB Hotspot licenses may use this file in
+  accordance with Hotspot Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QMetaType>
+#include <QPair>
+#include <QVector>
+
+/**
+ * The number of samples of a stack, which is an index into the StackTable of a profile.
+ */
+struct StackCount
+{
+    qint32 stack = -1;
+    quint32 count = 0;
+};
+
+Q_DECLARE_TYPEINFO(StackCount, Q_PRIMITIVE_TYPE);
+
+/**
+ * The samples of a profile aggregated per stack and fixed time bucket.
+ *
+ * The buckets are the leaves of a segment tree, in which every node holds the stack counts
+ * of all buckets below it. The stack counts of any time range then are a merge of
+ * O(log n) nodes, instead of a walk over all samples in the range.
+ *
+ * The number of buckets is limited, when the samples span more buckets the bucket size
+ * grows by a whole factor, so that a single outlier does not exhaust the memory.
+ */
+class TimeBucketTree
+{
+public:
+    // 10ms, in nanoseconds like the sample times
+    enum : quint64 { DefaultBucketSize = 10000000 };
+    // about three hours of the default bucket size
+    enum : int { MaxBucketCount = 1 << 20 };
+
+    explicit TimeBucketTree(quint64 bucketSize = DefaultBucketSize);
+
+    quint64 bucketSize() const;
+
+    /**
+     * Add a sample of the @p stack at @p time, the samples can be added in any order.
+     */
+    void addSample(quint64 time, qint32 stack);
+
+    /**
+     * Build the segment tree once all samples are added.
+     *
+     * Afterwards the bucket size is a multiple of the one the tree was created with, when the
+     * samples span more than MaxBucketCount buckets.
+     */
+    void build();
+
+    /**
+     * @return the counts of all stacks with samples in the buckets that overlap
+     *         the time range [@p startTime, @p endTime], sorted by the stack
+     */
+    QVector<StackCount> stackCounts(quint64 startTime, quint64 endTime) const;
+
+private:
+    struct Sample
+    {
+        quint64 bucket;
+        qint32 stack;
+        quint32 count;
+    };
+
+    quint64 m_bucketSize;
+    // the sample count per bucket and stack that were added since the last build
+    QHash<QPair<quint64, qint32>, quint32> m_sampleCounts;
+    quint64 m_firstBucket = 0;
+    // the number of leaves in the segment tree
+    int m_bucketCount = 0;
+    // the stack counts of all nodes of the segment tree, the ones of a node start at its
+    // entry in m_nodeOffsets. The leaves are the nodes [m_bucketCount, 2 * m_bucketCount).
+    QVector<StackCount> m_counts;
+    QVector<int> m_nodeOffsets;
+};
+
+Q_DECLARE_METATYPE(TimeBucketTree)
+Q_DECLARE_TYPEINFO(TimeBucketTree, Q_MOVABLE_TYPE);
@@ -34,14 +34,31 @@
 #include <QDataStream>
 #include <QFileInfo>
 #include <QLoggingCategory>
+#include <QMutex>
 
 #include <ThreadWeaver/ThreadWeaver>
 
-#include <models/framedata.h>
+#include <models/callercalleebuilder.h>
+#include <models/callgraph.h>
+#include <models/chunkmerger.h>
+#include <models/calltree.h>
+#include <models/frametable.h>
+#include <models/locationtable.h>
+#include <models/parsedinput.h>
+#include <models/profile.h>
+#include <models/samplestore.h>
+#include <models/sourcecosttable.h>
+#include <models/stackfolder.h>
+#include <models/stacktable.h>
 #include <models/summarydata.h>
+#include <models/threadtable.h>
+#include <models/timebuckettree.h>
 
 #include <util.h>
 
+#include <algorithm>
+#include <vector>
+
 Q_LOGGING_CATEGORY(LOG_PERFPARSER, "hotspot.perfparser", QtWarningMsg)
 
 namespace {
@@ -478,85 +495,98 @@ QDebug operator<<(QDebug stream, const FeaturesDefinition& featuresDefinition)
     return stream;
 }
 
-struct LocationData
+struct ProcessData
 {
-    LocationData(qint32 parentLocationId = -1, const QString& location = {},
-                 const QString& address = {})
-        : parentLocationId(parentLocationId)
-        , location(location)
-        , address(address)
-    { }
-
-    qint32 parentLocationId = -1;
-    QString location;
-    QString address;
+    quint32 pid = 0;
+    // the command of the main thread
+    QString comm;
 };
 
-struct SymbolData
+struct StackKey
 {
-    QString symbol;
-    QString binary;
-
-    bool isValid() const
-    {
-        return !symbol.isEmpty() || !binary.isEmpty();
-    }
+    // index into the list of processes
+    qint32 process = 0;
+    quint32 tid = 0;
+    QVector<qint32> frames;
 };
 
-struct CallerCalleeLocation
+inline bool operator==(const StackKey& lhs, const StackKey& rhs)
 {
-    QString symbol;
-    QString binary;
-
-    bool operator<(const CallerCalleeLocation &location) const
-    {
-        return std::tie(symbol, binary) < std::tie(location.symbol, location.binary);
-    }
-};
+    return lhs.process == rhs.process && lhs.tid == rhs.tid && lhs.frames == rhs.frames;
+}
 
-inline bool operator==(const CallerCalleeLocation &location1, const CallerCalleeLocation &location2)
+inline uint qHash(const StackKey& key, uint seed = 0)
 {
-    return location1.symbol == location2.symbol && location1.binary == location2.binary;
+    Util::HashCombine hash;
+    seed = hash(seed, key.process);
+    seed = hash(seed, key.tid);
+    seed = hash(seed, key.frames);
+    return seed;
 }
 
-inline bool operator!=(const CallerCalleeLocation &location1, const CallerCalleeLocation &location2)
+struct UniqueStack
 {
-    return !(location1.symbol == location2.symbol && location1.binary == location2.binary);
-}
+    StackKey key;
+    // the number of samples with this stack
+    quint32 count = 0;
+};
 
-inline uint qHash(const CallerCalleeLocation &key, uint seed = 0)
+/**
+ * Build a result from @p stackCount stacks in parallel jobs that each @p build a chunk of the stacks.
+ *
+ * The results of the chunks get combined with @p merge in the order of the chunks as soon as
+ * neighboring ones are ready, see ChunkMerger. The job that merges last passes the combined
+ * result to @p done.
+ */
+template<typename Result, typename Build, typename Merge, typename Done>
+void buildInChunks(int stackCount, Build build, Merge merge, Done done)
 {
-    Util::HashCombine hash;
-    seed = hash(seed, key.symbol);
-    seed = hash(seed, key.binary);
-    return seed;
+    // large enough that merging the results stays cheap compared to building them
+    const int chunkSize = 20000;
+    const int chunks = std::max(1, (stackCount + chunkSize - 1) / chunkSize);
+    auto merger = std::make_shared<ChunkMerger<Result>>(chunks);
+
+    using namespace ThreadWeaver;
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        const int begin = chunk * chunkSize;
+        const int end = std::min(begin + chunkSize, stackCount);
+        stream() << make_job([chunk, begin, end, build, merge, done, merger]() {
+            auto result = merger->addChunk(chunk, std::make_unique<Result>(build(begin, end)), merge);
+            if (result) {
+                // this is the last merge, no other job will access the merger anymore
+                done(*result);
+            }
+        });
+    }
 }
 
 }
 
 Q_DECLARE_TYPEINFO(AttributesDefinition, Q_MOVABLE_TYPE);
-Q_DECLARE_TYPEINFO(LocationData, Q_MOVABLE_TYPE);
-Q_DECLARE_TYPEINFO(SymbolData, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(ProcessData, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(StackKey, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(UniqueStack, Q_MOVABLE_TYPE);
 
-struct PerfParserPrivate
+struct PerfParserPrivate : ParsedInput
 {
     PerfParserPrivate()
+        : process(new QProcess)
     {
         buffer.buffer().reserve(1024);
         buffer.open(QIODevice::ReadOnly);
         stream.setDevice(&buffer);
-        process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
     }
 
     bool tryParse()
     {
-        const auto bytesAvailable = process.bytesAvailable();
+        const auto bytesAvailable = process->bytesAvailable();
         switch (state) {
             case HEADER: {
                 const auto magic = QByteArrayLiteral("QPERFSTREAM");
                 // + 1 to include the trailing \0
                 if (bytesAvailable >= magic.size() + 1) {
-                    process.read(buffer.buffer().data(), magic.size() + 1);
+                    process->read(buffer.buffer().data(), magic.size() + 1);
                     if (buffer.buffer().data() != magic) {
                         state = PARSE_ERROR;
                         qCWarning(LOG_PERFPARSER) << "Failed to read header magic";
@@ -571,7 +601,7 @@ struct PerfParserPrivate
             case DATA_STREAM_VERSION: {
                 qint32 dataStreamVersion = 0;
                 if (bytesAvailable >= static_cast<qint64>(sizeof(dataStreamVersion))) {
-                    process.read(buffer.buffer().data(), sizeof(dataStreamVersion));
+                    process->read(buffer.buffer().data(), sizeof(dataStreamVersion));
                     dataStreamVersion = qFromLittleEndian(*reinterpret_cast<qint32*>(buffer.buffer().data()));
                     stream.setVersion(dataStreamVersion);
                     qCDebug(LOG_PERFPARSER) << "data stream version is:" << dataStreamVersion;
@@ -582,7 +612,7 @@ struct PerfParserPrivate
             }
             case EVENT_HEADER:
                 if (bytesAvailable >= static_cast<qint64>((eventSize))) {
-                    process.read(buffer.buffer().data(), sizeof(eventSize));
+                    process->read(buffer.buffer().data(), sizeof(eventSize));
                     eventSize = qFromLittleEndian(*reinterpret_cast<quint32*>(buffer.buffer().data()));
                     qCDebug(LOG_PERFPARSER) << "next event size is:" << eventSize;
                     state = EVENT;
@@ -592,7 +622,7 @@ struct PerfParserPrivate
             case EVENT:
                 if (bytesAvailable >= static_cast<qint64>(eventSize)) {
                     buffer.buffer().resize(eventSize);
-                    process.read(buffer.buffer().data(), eventSize);
+                    process->read(buffer.buffer().data(), eventSize);
                     if (!parseEvent()) {
                         state = PARSE_ERROR;
                         return false;
@@ -713,12 +743,8 @@ struct PerfParserPrivate
 
     void finalize()
     {
-        FrameData::initializeParents(&bottomUpResult);
-
+        resolveStacks();
         calculateSummary();
-
-        buildTopDownResult();
-        buildCallerCalleeResult();
     }
 
     void addAttributes(const AttributesDefinition& attributesDefinition)
@@ -728,197 +754,252 @@ struct PerfParserPrivate
 
     void addCommand(const Command& command)
     {
-        // TODO: keep track of list of commands for filtering later on
-        Q_UNUSED(command);
+        const auto comm = frameTable.string(stringId(command.comm.id));
+        threadNames[command.tid] = comm;
+
+        // the command of the main thread names the process, other threads only rename themselves
+        auto it = processIds.constFind(command.pid);
+        if (it != processIds.constEnd() && command.pid != command.tid) {
+            return;
+        }
+
+        if (it == processIds.constEnd()) {
+            processIds.insert(command.pid, processes.size());
+            processes.append({command.pid, comm});
+        } else if (processes[it.value()].comm.isEmpty()) {
+            processes[it.value()].comm = comm;
+        } else if (processes[it.value()].comm != comm) {
+            // the process got renamed, e.g. after an exec, group its following samples separately
+            processIds[command.pid] = processes.size();
+            processes.append({command.pid, comm});
+        }
     }
 
-    void addLocation(const LocationDefinition& location)
+    qint32 processIndex(quint32 pid)
     {
-        Q_ASSERT(locations.size() == location.id);
-        Q_ASSERT(symbols.size() == location.id);
-        QString locationString;
-        if (location.location.file.id != -1) {
-            locationString = strings.value(location.location.file.id);
-            if (location.location.line != -1) {
-                locationString += QLatin1Char(':') + QString::number(location.location.line);
-            }
+        auto it = processIds.find(pid);
+        if (it == processIds.end()) {
+            it = processIds.insert(pid, processes.size());
+            processes.append({pid, {}});
         }
-        locations.push_back({
-            location.location.parentLocationId,
-            locationString,
-            QString::number(location.location.address, 16)
-        });
-        symbols.push_back({});
+        return it.value();
+    }
+
+    void addLocation(const LocationDefinition& location)
+    {
+        Q_ASSERT(locationTable.size() == location.id);
+        // the location only gets formatted when it is displayed
+        locationTable.addLocation(location.location.parentLocationId, location.location.address,
+                                  stringId(location.location.file.id), location.location.line,
+                                  location.location.column);
     }
 
     void addSymbol(const SymbolDefinition& symbol)
     {
         // TODO: do we need to handle pid/tid here?
-        // TODO: store binary, isKernel information
-        Q_ASSERT(symbols.size() > symbol.id);
-        symbols[symbol.id] = {
-            strings.value(symbol.symbol.name.id),
-            strings.value(symbol.symbol.binary.id)
-        };
+        locationTable.setSymbol(symbol.id, stringId(symbol.symbol.name.id), stringId(symbol.symbol.binary.id),
+                                symbol.symbol.isKernel);
     }
 
-    static FrameData* addFrame(FrameData* parent,
-                               const QString& symbol, const QString& binary,
-                               const QString& location, const QString& address)
+    /**
+     * @return the ids of the resolved frames of @p stack, starting with the innermost frame
+     */
+    QVector<qint32> resolveStack(const StackKey& stack)
     {
-        FrameData* ret = nullptr;
-
-        for (auto row = parent->children.data(), end = row + parent->children.size();
-             row != end; ++row)
-        {
-            // TODO: implement aggregation, i.e. to ignore location address
-            if (row->symbol == symbol && row->binary == binary
-                && row->location == location && row->address == address)
-            {
-                ret = row;
-                break;
-            }
-        }
-
-        if (!ret) {
-            FrameData frame;
-            frame.symbol = symbol;
-            frame.binary = binary;
-            frame.location = location;
-            frame.address = address;
-            parent->children.append(frame);
-            ret = &parent->children.last();
+        QVector<qint32> frames;
+        frames.reserve(stack.frames.size());
+        for (auto id : stack.frames) {
+            frames += locationTable.framesForLocation(id);
         }
-
-        return ret;
+        return frames;
     }
 
-    FrameData* addFrame(FrameData* parent, qint32 id) const
+    qint32 processFrame(qint32 index)
     {
-        bool skipNextFrame = false;
-        while (id != -1) {
-            const auto& location = locations.value(id);
-            if (skipNextFrame) {
-                id = location.parentLocationId;
-                skipNextFrame = false;
-                continue;
-            }
-
-            auto symbol = symbols.value(id);
-            if (!symbol.isValid()) {
-                // we get function entry points from the perfparser but
-                // those are imo not interesting - skip them
-                symbol = symbols.value(location.parentLocationId);
-                skipNextFrame = true;
-            }
-
-            auto ret = addFrame(parent, symbol.symbol, symbol.binary,
-                                location.location, location.address);
-
-            ++ret->inclusiveCost;
-            if (parent == &bottomUpResult) {
-                ++ret->selfCost;
-            }
-
-            parent = ret;
-            id = location.parentLocationId;
+        while (processFrameIds.size() < processes.size()) {
+            processFrameIds.append(-1);
         }
+        auto& frameId = processFrameIds[index];
+        if (frameId == -1) {
+            const auto& process = processes.at(index);
+            Frame frame;
+            frame.symbol = frameTable.internString(process.comm.isEmpty()
+                ? QString::number(process.pid)
+                : QStringLiteral("%1 (%2)").arg(process.comm).arg(process.pid));
+            // the same pid can occur in multiple inputs, which are unrelated processes
+            frame.file = frameTable.internString(inputPath);
+            frame.isProcess = true;
+            frameId = frameTable.internFrame(frame);
+        }
+        return frameId;
+    }
 
-        return parent;
+    /**
+     * The sample is attributed to the kernel when the innermost resolved frame is in kernel space.
+     */
+    quint32 kernelCostForStack(const UniqueStack& stack, const QVector<qint32>& frames) const
+    {
+        return !frames.isEmpty() && frameTable.frame(frames.first()).isKernel ? stack.count : 0;
     }
 
     void addSample(const Sample& sample)
     {
-        addSampleToBottomUp(sample);
+        addSampleToStacks(sample);
         addSampleToSummary(sample);
     }
 
     void addString(const StringDefinition& string)
     {
-        Q_ASSERT(string.id == strings.size());
-        strings.push_back(QString::fromUtf8(string.string));
+        Q_ASSERT(string.id == stringIds.size());
+        stringIds.push_back(frameTable.internString(string.string));
+    }
+
+    /**
+     * @return the id in the frame table for the string with the perfparser id @p id
+     */
+    qint32 stringId(qint32 id) const
+    {
+        return stringIds.value(id, -1);
     }
 
-    void addSampleToBottomUp(const Sample& sample)
+    /**
+     * Repeated samples only increment the count of their unique stack,
+     * the trees get built from the unique stacks once all samples are known.
+     */
+    void addSampleToStacks(const Sample& sample)
     {
-        ++bottomUpResult.inclusiveCost;
-        auto parent = &bottomUpResult;
-        for (auto id : sample.frames) {
-            parent = addFrame(parent, id);
+        const StackKey key{processIndex(sample.pid), sample.tid, sample.frames};
+        auto it = stackIds.find(key);
+        if (it == stackIds.end()) {
+            it = stackIds.insert(key, stacks.size());
+            stacks.append({key, 0});
         }
+
+        timeline.addSample(sample.time, it.value());
+        sampleStore.addSample({sample.time, sample.pid, sample.tid, it.value(), sample.attributeId});
+
+        ++stacks[it.value()].count;
     }
 
-    static void buildTopDownResult(const QVector<FrameData>& bottomUpData, FrameData* topDownData)
+    /**
+     * Resolve the frames of all unique stacks, so that the trees can then be built
+     * concurrently without modifying the frame table.
+     */
+    void resolveStacks()
     {
-        foreach (const auto& row, bottomUpData) {
-            if (row.children.isEmpty()) {
-                // leaf node found, bubble up the parent chain to build a top-down tree
-                auto node = &row;
-                auto stack = topDownData;
-                while (node) {
-                    auto frame = addFrame(stack,
-                                          node->symbol, node->binary,
-                                          node->location, node->address);
-
-                    // always use the leaf node's cost and propagate that one up the chain
-                    // otherwise we'd count the cost of some nodes multiple times
-                    frame->inclusiveCost += row.inclusiveCost;
-                    if (node == &row) {
-                        frame->selfCost += 1;
-                    }
-                    stack = frame;
-                    node = node->parent;
-                }
-            } else {
-                // recurse to find a leaf
-                buildTopDownResult(row.children, topDownData);
+        StackFolder folder(&frameTable);
+        folder.setAggregation(aggregation);
+        folder.setFoldingRules(foldingRules);
+        folder.setCollapseKernelFrames(collapseKernelFrames);
+        for (const auto& stack : stacks) {
+            const auto resolvedFrames = resolveStack(stack.key);
+            // the folding must not change where the sample was taken
+            const auto kernelCost = kernelCostForStack(stack, resolvedFrames);
+            const auto frames = folder.foldStack(resolvedFrames);
+            // only the bottom-up and top-down trees leave out the recursive calls
+            const auto recursiveFrames = foldRecursion ? findRecursiveFrames(frameTable, frames) : QBitArray();
+            const auto processFrameId = groupByProcess ? processFrame(stack.key.process) : -1;
+            stackTable.addStack(frames, processFrameId, stack.count, kernelCost, recursiveFrames);
+            threadTable.addStack(threadIndex(stack.key), stackTable.size() - 1, stack.count);
+            addStackToBinaryCosts(resolvedFrames, stack.count);
+            addStackToLineCosts(resolvedFrames, stack.count);
+        }
+        indexLineCosts();
+    }
+
+    /**
+     * Attribute the @p count samples of a resolved stack to the binaries of its @p frames,
+     * the inclusive cost of a binary is only counted once per stack.
+     *
+     * The frames must not be folded, a frame that a folding rule merges or collapses
+     * would otherwise hide the binaries below it.
+     */
+    void addStackToBinaryCosts(const QVector<qint32>& frames, quint32 count)
+    {
+        ++binaryEpoch;
+        for (int i = 0; i < frames.size(); ++i) {
+            const auto binary = frameTable.frame(frames.at(i)).binary;
+            auto it = binaryIds.find(binary);
+            if (it == binaryIds.end()) {
+                it = binaryIds.insert(binary, binaryCosts.size());
+                binaryCosts.append({frameTable.string(binary), 0, 0});
+                binaryEpochs.append(0);
+            }
+
+            auto& cost = binaryCosts[it.value()];
+            if (i == 0) {
+                cost.selfCost += count;
+            }
+            if (binaryEpochs.at(it.value()) != binaryEpoch) {
+                binaryEpochs[it.value()] = binaryEpoch;
+                cost.inclusiveCost += count;
             }
         }
     }
 
-    void buildTopDownResult()
+    /**
+     * @return the index in the thread table of the thread of the stack with the @p key
+     */
+    int threadIndex(const StackKey& key)
     {
-        buildTopDownResult(bottomUpResult.children, &topDownResult);
-        FrameData::initializeParents(&topDownResult);
+        const auto thread = qMakePair(key.process, key.tid);
+        auto it = threadIds.find(thread);
+        if (it == threadIds.end()) {
+            const auto& process = processes.at(key.process);
+            it = threadIds.insert(thread, threadTable.addThread(process.pid, key.tid,
+                                                                threadNames.value(key.tid, process.comm)));
+        }
+        return it.value();
     }
 
-    static void buildCallerCalleeResult(const QVector<FrameData>& bottomUpData, FrameData* callerCalleeData)
+    /**
+     * Attribute the @p count samples of a resolved stack to the source lines of its @p frames,
+     * the inclusive cost of a line is only counted once per stack.
+     *
+     * Like for the binary costs, the frames must neither be aggregated nor folded, the
+     * lines are known for all aggregations then.
+     */
+    void addStackToLineCosts(const QVector<qint32>& frames, quint32 count)
     {
-        for (const FrameData& row : bottomUpData) {
-            if (row.children.isEmpty()) {
-                // leaf node found, bubble up the parent chain to add cost for all frames
-                // to the caller/callee data. this is done top-down since we must not count
-                // symbols more than once in the caller-callee data
-                QSet<CallerCalleeLocation> recursionGuard;
-                auto node = &row;
-
-                while (node) {
-                    CallerCalleeLocation needle{node->symbol, node->binary};
-                    if (!recursionGuard.contains(needle)) { // aggregate caller-callee data
-                        auto it = std::lower_bound(callerCalleeData->children.begin(), callerCalleeData->children.end(), needle,
-                            [](const FrameData& frame, const auto needle) { return CallerCalleeLocation{frame.symbol, frame.binary} < needle; });
-
-                        if (it == callerCalleeData->children.end() || CallerCalleeLocation{it->symbol, it->binary} != needle) {
-                            it = callerCalleeData->children.insert(it, {node->symbol, node->binary, node->location, node->address, 0, 0, {}, nullptr});
-                        }
-                        it->inclusiveCost += 1;
-                        if (!node->parent) {
-                            it->selfCost += 1;
-                        }
-                        recursionGuard.insert(needle);
-                    }
-                    node = node->parent;
-                }
-            } else {
-                // recurse to find a leaf
-                buildCallerCalleeResult(row.children, callerCalleeData);
+        ++lineEpoch;
+        for (int i = 0; i < frames.size(); ++i) {
+            const auto& frame = frameTable.frame(frames.at(i));
+            if (frame.file == -1 || frame.line <= 0) {
+                continue;
+            }
+
+            const auto location = qMakePair(frame.file, frame.line);
+            auto it = lineIds.find(location);
+            if (it == lineIds.end()) {
+                it = lineIds.insert(location, lineCosts.size());
+                lineCosts.append({frame.line, 0, 0});
+                lineFiles.append(frame.file);
+                lineEpochs.append(0);
+            }
+
+            auto& cost = lineCosts[it.value()];
+            if (i == 0) {
+                cost.selfCost += count;
+            }
+            if (lineEpochs.at(it.value()) != lineEpoch) {
+                lineEpochs[it.value()] = lineEpoch;
+                cost.inclusiveCost += count;
             }
         }
     }
 
-    void buildCallerCalleeResult()
+    /**
+     * Group the line costs by their file, so that the source view only looks up the lines of one file.
+     */
+    void indexLineCosts()
     {
-        buildCallerCalleeResult(bottomUpResult.children, &callerCalleeResult);
+        QHash<qint32, QVector<LineCost>> fileCosts;
+        for (int i = 0; i < lineCosts.size(); ++i) {
+            fileCosts[lineFiles.at(i)].append(lineCosts.at(i));
+        }
+        for (auto it = fileCosts.constBegin(), end = fileCosts.constEnd(); it != end; ++it) {
+            sourceCosts.addLineCosts(frameTable.string(it.key()), it.value());
+        }
     }
 
     void addSampleToSummary(const Sample& sample)
@@ -936,14 +1017,21 @@ struct PerfParserPrivate
 
     void calculateSummary()
     {
+        summaryResult.applicationStartTime = applicationStartTime;
         summaryResult.applicationRunningTime = applicationEndTime - applicationStartTime;
         summaryResult.threadCount = uniqueThreads.size();
         summaryResult.processCount = uniqueProcess.size();
+        for (const auto& rule : foldingRules) {
+            summaryResult.foldingRules.append(rule.toString());
+        }
+        summaryResult.addBinaryCosts(binaryCosts);
+        calculateLostIntervals();
     }
 
-    void addLost(const LostDefinition& /*lost*/)
+    void addLost(const LostDefinition& lost)
     {
         ++summaryResult.lostChunks;
+        lostTimes.append(lost.time);
     }
 
     void setFeatures(const FeaturesDefinition& features)
@@ -983,19 +1071,52 @@ struct PerfParserPrivate
     quint32 eventSize = 0;
     QBuffer buffer;
     QDataStream stream;
-    FrameData bottomUpResult;
-    FrameData topDownResult;
     QVector<AttributesDefinition> attributes;
-    QVector<SymbolData> symbols;
-    QVector<LocationData> locations;
-    QVector<QString> strings;
-    QProcess process;
-    SummaryData summaryResult;
+    // maps the string ids of the perfparser to the ones in the frame table
+    QVector<qint32> stringIds;
+    // the process gets destroyed in the thread that parsed its output,
+    // the remaining data can then be merged with the results of other processes
+    std::unique_ptr<QProcess> process;
     quint64 applicationStartTime = 0;
     quint64 applicationEndTime = 0;
     QSet<quint32> uniqueThreads;
     QSet<quint32> uniqueProcess;
-    FrameData callerCalleeResult;
+    // the file that is parsed, it tells the processes of different inputs apart
+    QString inputPath;
+    bool collapseKernelFrames = false;
+    bool groupByProcess = false;
+    PerfParser::Aggregation aggregation = PerfParser::Aggregation::Address;
+    QVector<FoldingRule> foldingRules;
+    bool foldRecursion = false;
+    // the cost per binary, see addStackToBinaryCosts
+    QVector<BinaryCost> binaryCosts;
+    // maps the string id of a binary to its index in binaryCosts
+    QHash<qint32, int> binaryIds;
+    // the last epoch in which a stack added to the inclusive cost of a binary
+    QVector<quint32> binaryEpochs;
+    quint32 binaryEpoch = 0;
+    // the cost per source line, with the file id of every line, see addStackToLineCosts
+    QVector<LineCost> lineCosts;
+    QVector<qint32> lineFiles;
+    // maps the file id and line to the index in lineCosts
+    QHash<QPair<qint32, qint32>, int> lineIds;
+    // the last epoch in which a stack added to the inclusive cost of a line
+    QVector<quint32> lineEpochs;
+    quint32 lineEpoch = 0;
+    QVector<ProcessData> processes;
+    // maps the pid to the index of its current entry in processes
+    QHash<quint32, qint32> processIds;
+    // the latest command of every thread
+    QHash<quint32, QString> threadNames;
+    // maps the process index and tid to the index of the thread in threadTable
+    QHash<QPair<qint32, quint32>, int> threadIds;
+    QVector<UniqueStack> stacks;
+    // the frame id for every process index, see processFrame
+    QVector<qint32> processFrameIds;
+    // the locations and symbols of the perfparser, which resolve into frames of frameTable
+    LocationTable locationTable{&frameTable};
+    // maps the stack to its index in stacks
+    QHash<StackKey, qint32> stackIds;
 };
 
 PerfParser::PerfParser(QObject* parent)
@@ -1005,20 +1126,88 @@ PerfParser::PerfParser(QObject* parent)
 
 PerfParser::~PerfParser() = default;
 
+void PerfParser::setCollapseKernelFrames(bool collapse)
+{
+    m_collapseKernelFrames = collapse;
+}
+
+bool PerfParser::collapseKernelFrames() const
+{
+    return m_collapseKernelFrames;
+}
+
+void PerfParser::setGroupByProcess(bool group)
+{
+    m_groupByProcess = group;
+}
+
+bool PerfParser::groupByProcess() const
+{
+    return m_groupByProcess;
+}
+
+void PerfParser::setAggregation(Aggregation aggregation)
+{
+    m_aggregation = aggregation;
+}
+
+PerfParser::Aggregation PerfParser::aggregation() const
+{
+    return m_aggregation;
+}
+
+void PerfParser::setFoldRecursion(bool fold)
+{
+    m_foldRecursion = fold;
+}
+
+bool PerfParser::foldRecursion() const
+{
+    return m_foldRecursion;
+}
+
+void PerfParser::setFoldingRules(const QVector<FoldingRule>& rules)
+{
+    m_foldingRules = rules;
+}
+
+QVector<FoldingRule> PerfParser::foldingRules() const
+{
+    return m_foldingRules;
+}
+
 void PerfParser::startParseFile(const QString& path)
 {
-    QFileInfo info(path);
-    if (!info.exists()) {
-        emit parsingFailed(tr("File '%1' does not exist.").arg(path));
-        return;
-    }
-    if (!info.isFile()) {
-        emit parsingFailed(tr("'%1' is not a file.").arg(path));
-        return;
-    }
-    if (!info.isReadable()) {
-        emit parsingFailed(tr("File '%1' is not readable.").arg(path));
-        return;
+    startParseFiles({path});
+}
+
+void PerfParser::stop()
+{
+    ++m_parseGeneration;
+}
+
+void PerfParser::startParseFiles(const QStringList& paths)
+{
+    // the results of a parse operation that is still running would overwrite the new ones
+    const auto generation = ++m_parseGeneration;
+    auto isCurrent = [generation, this]() {
+        return generation == m_parseGeneration;
+    };
+
+    for (const auto& path : paths) {
+        QFileInfo info(path);
+        if (!info.exists()) {
+            emit parsingFailed(tr("File '%1' does not exist.").arg(path));
+            return;
+        }
+        if (!info.isFile()) {
+            emit parsingFailed(tr("'%1' is not a file.").arg(path));
+            return;
+        }
+        if (!info.isReadable()) {
+            emit parsingFailed(tr("File '%1' is not readable.").arg(path));
+            return;
+        }
     }
 
     const auto parserBinary = Util::findLibexecBinary(QStringLiteral("hotspot-perfparser"));
@@ -1027,45 +1216,196 @@ void PerfParser::startParseFile(const QString& path)
         return;
     }
 
+    // every input file is parsed and finalized by its own hotspot-perfparser process in a
+    // separate job, the last job to finish merges the results and builds the trees from them
+    struct ParseState
+    {
+        QMutex mutex;
+        int pendingJobs = 0;
+        bool failed = false;
+        // the results in the order of the paths, they are merged in that order
+        std::vector<std::unique_ptr<PerfParserPrivate>> results;
+    };
+    auto state = std::make_shared<ParseState>();
+    state->pendingJobs = paths.size();
+    state->results.resize(paths.size());
+
+    auto fail = [state, isCurrent, this] (const QString& errorMessage) {
+        QMutexLocker lock(&state->mutex);
+        if (!state->failed) {
+            state->failed = true;
+            if (isCurrent()) {
+                emit parsingFailed(errorMessage);
+            }
+        }
+    };
+
     using namespace ThreadWeaver;
-    stream() << make_job([path, parserBinary, this]() {
-        PerfParserPrivate d;
+    for (int input = 0; input < paths.size(); ++input) {
+        const auto& path = paths.at(input);
+        stream() << make_job([input, path, parserBinary, state, fail, isCurrent, collapseKernelFrames = m_collapseKernelFrames,
+                              groupByProcess = m_groupByProcess, aggregation = m_aggregation,
+                              foldingRules = m_foldingRules, foldRecursion = m_foldRecursion, this]() {
+            auto d = std::make_unique<PerfParserPrivate>();
+            d->inputPath = path;
+            d->collapseKernelFrames = collapseKernelFrames;
+            d->groupByProcess = groupByProcess;
+            d->aggregation = aggregation;
+            d->foldingRules = foldingRules;
+            d->foldRecursion = foldRecursion;
+            bool success = false;
+
+            connect(d->process.get(), &QProcess::readyRead,
+                    [&d, isCurrent] {
+                        if (!isCurrent()) {
+                            // a newer parse operation was started, its results would be discarded
+                            d->process->kill();
+                            return;
+                        }
+                        while (d->tryParse()) {
+                            // just call tryParse until it fails
+                        }
+                    });
+
+            connect(d->process.get(), static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+                    [&success, fail] (int exitCode, QProcess::ExitStatus exitStatus) {
+                        qCDebug(LOG_PERFPARSER) << exitCode << exitStatus;
+
+                        if (exitCode == EXIT_SUCCESS) {
+                            success = true;
+                        } else {
+                            fail(tr("The hotspot-perfparser binary exited with code %1.").arg(exitCode));
+                        }
+                    });
+
+            connect(d->process.get(), &QProcess::errorOccurred,
+                    [&d, fail] (QProcess::ProcessError error) {
+                        qCWarning(LOG_PERFPARSER) << error << d->process->errorString();
+
+                        fail(d->process->errorString());
+                    });
+
+            d->process->start(parserBinary, {QStringLiteral("--input"), path});
+            if (!d->process->waitForStarted()) {
+                fail(tr("Failed to start the hotspot-perfparser process"));
+            } else {
+                d->process->waitForFinished(-1);
+            }
+            d->process.reset();
+            if (!success) {
+                // this is a noop if an error was reported already
+                fail(tr("Failed to parse file '%1'.").arg(path));
+            } else {
+                d->finalize();
+            }
+
+            QMutexLocker lock(&state->mutex);
+            if (success && !state->failed) {
+                state->results[input] = std::move(d);
+            }
+            if (--state->pendingJobs > 0 || state->failed || !isCurrent()) {
+                return;
+            }
+            lock.unlock();
 
-        connect(&d.process, &QProcess::readyRead,
-                [&d] {
-                    while (d.tryParse()) {
-                        // just call tryParse until it fails
+            // this is the last job, no other job will access the shared state anymore
+            auto result = std::move(state->results.front());
+            for (std::size_t i = 1; i < state->results.size(); ++i) {
+                result->merge(*state->results[i]);
+                state->results[i].reset();
+            }
+            auto stacks = result->stackTable;
+            const auto frames = result->frameTable;
+            // the symbol index is used to filter the trees later on
+            stacks.indexSymbols(frames);
+            auto timeline = result->timeline;
+            timeline.build();
+
+            // every result gets published once it is ready, as part of an immutable profile
+            // that shares all results which were published before
+            struct ProfileState
+            {
+                QMutex mutex;
+                Profile profile;
+                int pendingResults = 3;
+            };
+            auto profileState = std::make_shared<ProfileState>();
+            profileState->profile = Profile().withSummary(frames, result->summaryResult)
+                                             .withStacks(stacks).withTimeline(timeline)
+                                             .withSamples(result->sampleStore)
+                                             .withThreads(result->threadTable)
+                                             .withSourceCosts(result->sourceCosts);
+            result.reset();
+            if (!isCurrent()) {
+                return;
+            }
+            emit summaryDataAvailable(profileState->profile);
+
+            // the results are emitted while locked, so that the profiles arrive in the order they
+            // were published, parsingFinished follows the last one. The results of an outdated
+            // parse operation are dropped, the signals of the newer one are emitted after them.
+            auto finish = [profileState, this]() {
+                if (--profileState->pendingResults == 0) {
+                    emit parsingFinished();
+                }
+            };
+
+            buildInChunks<CallTree>(stacks.size(),
+                [stacks](int begin, int end) {
+                    CallTree tree;
+                    for (int stack = begin; stack < end; ++stack) {
+                        stacks.addToBottomUp(&tree, stack);
+                    }
+                    return tree;
+                },
+                [](CallTree* tree, const CallTree& chunk) { tree->merge(chunk); },
+                [profileState, finish, isCurrent, this](const CallTree& tree) {
+                    QMutexLocker lock(&profileState->mutex);
+                    if (!isCurrent()) {
+                        return;
                     }
+                    profileState->profile = profileState->profile.withBottomUp(tree);
+                    emit bottomUpDataAvailable(profileState->profile);
+                    finish();
                 });
 
-        connect(&d.process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
-                [&d, this] (int exitCode, QProcess::ExitStatus exitStatus) {
-                    qCDebug(LOG_PERFPARSER) << exitCode << exitStatus;
-
-                    if (exitCode == EXIT_SUCCESS) {
-                        d.finalize();
-                        emit bottomUpDataAvailable(d.bottomUpResult);
-                        emit topDownDataAvailable(d.topDownResult);
-                        emit summaryDataAvailable(d.summaryResult);
-                        emit callerCalleeDataAvailable(d.callerCalleeResult);
-                        emit parsingFinished();
-                    } else {
-                        emit parsingFailed(tr("The hotspot-perfparser binary exited with code %1.").arg(exitCode));
+            buildInChunks<CallTree>(stacks.size(),
+                [stacks](int begin, int end) {
+                    CallTree tree;
+                    for (int stack = begin; stack < end; ++stack) {
+                        stacks.addToTopDown(&tree, stack);
+                    }
+                    return tree;
+                },
+                [](CallTree* tree, const CallTree& chunk) { tree->merge(chunk); },
+                [profileState, finish, isCurrent, this](const CallTree& tree) {
+                    QMutexLocker lock(&profileState->mutex);
+                    if (!isCurrent()) {
+                        return;
                     }
+                    profileState->profile = profileState->profile.withTopDown(tree);
+                    emit topDownDataAvailable(profileState->profile);
+                    finish();
                 });
 
-        connect(&d.process, &QProcess::errorOccurred,
-                [&d, this] (QProcess::ProcessError error) {
-                    qCWarning(LOG_PERFPARSER) << error << d.process.errorString();
-
-                    emit parsingFailed(d.process.errorString());
+            buildInChunks<CallerCalleeBuilder>(stacks.size(),
+                [stacks, frames](int begin, int end) {
+                    CallerCalleeBuilder builder(frames);
+                    for (int stack = begin; stack < end; ++stack) {
+                        builder.addStack(stacks, stack);
+                    }
+                    return builder;
+                },
+                [](CallerCalleeBuilder* builder, const CallerCalleeBuilder& chunk) { builder->merge(chunk); },
+                [profileState, finish, isCurrent, this](const CallerCalleeBuilder& builder) {
+                    QMutexLocker lock(&profileState->mutex);
+                    if (!isCurrent()) {
+                        return;
+                    }
+                    profileState->profile = profileState->profile.withCallerCallee(builder.result(), builder.callGraph());
+                    emit callerCalleeDataAvailable(profileState->profile);
+                    finish();
                 });
-
-        d.process.start(parserBinary, {QStringLiteral("--input"), path});
-        if (!d.process.waitForStarted()) {
-            emit parsingFailed(tr("Failed to start the hotspot-perfparser process"));
-            return;
-        }
-        d.process.waitForFinished();
-    });
+        });
+    }
 }
@@ -28,11 +28,16 @@
 #pragma once
 
 #include <QObject>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
 #include <memory>
 
+#include "models/foldingrule.h"
+#include "models/stackfolder.h"
+
 struct PerfParserPrivate;
-struct FrameData;
-struct SummaryData;
+class Profile;
 
 // TODO: create a parser interface
 class PerfParser : public QObject
@@ -42,15 +47,71 @@ public:
     PerfParser(QObject* parent = nullptr);
     ~PerfParser();
 
+    using Aggregation = FrameAggregation;
+
+    /**
+     * Set the granularity at which frames get aggregated while parsing,
+     * coarser ones result in much smaller trees. This affects the next parse operation.
+     */
+    void setAggregation(Aggregation aggregation);
+    Aggregation aggregation() const;
+
+    /**
+     * The frames that match one of the @p rules get folded while parsing,
+     * the first matching rule is applied. This affects the next parse operation.
+     */
+    void setFoldingRules(const QVector<FoldingRule>& rules);
+    QVector<FoldingRule> foldingRules() const;
+
+    /**
+     * When enabled, all consecutive kernel frames of a sample get collapsed
+     * into a single "[kernel]" frame. This affects the next parse operation.
+     */
+    void setCollapseKernelFrames(bool collapse);
+    bool collapseKernelFrames() const;
+
+    /**
+     * When enabled, the samples of every process are grouped below a separate
+     * top level frame. This affects the next parse operation.
+     */
+    void setGroupByProcess(bool group);
+    bool groupByProcess() const;
+
+    /**
+     * When enabled, all direct and indirect recursive calls of a sample get folded into
+     * the innermost call of their function in the bottom-up and top-down trees, which
+     * bounds their depth. This affects the next parse operation.
+     */
+    void setFoldRecursion(bool fold);
+    bool foldRecursion() const;
+
     void startParseFile(const QString& path);
+    /**
+     * Parse all @p paths in parallel and merge them into a single profile.
+     */
+    void startParseFiles(const QStringList& paths);
+    /**
+     * Discard the results of the running parse operation, starting a new one does so as well.
+     */
+    void stop();
 
 signals:
-    void bottomUpDataAvailable(const FrameData& data);
-    void topDownDataAvailable(const FrameData& data);
-    // TODO: caller/callee data
+    // every signal publishes the profile with all results that are available so far
+    void summaryDataAvailable(const Profile& profile);
+    void bottomUpDataAvailable(const Profile& profile);
+    void topDownDataAvailable(const Profile& profile);
+    void callerCalleeDataAvailable(const Profile& profile);
     // TODO: progress bar
-    void summaryDataAvailable(const SummaryData& data);
-    void callerCalleeDataAvailable(const FrameData& data);
     void parsingFinished();
     void parsingFailed(const QString& errorMessage);
+
+private:
+    bool m_collapseKernelFrames = false;
+    bool m_groupByProcess = false;
+    bool m_foldRecursion = false;
+    Aggregation m_aggregation = Aggregation::Address;
+    QVector<FoldingRule> m_foldingRules;
+    // incremented whenever a parse operation starts or stops, the jobs of older ones
+    // then stop parsing and no longer publish their results
+    std::atomic<int> m_parseGeneration{0};
 };
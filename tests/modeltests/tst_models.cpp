@@ -26,6 +26,7 @@
 */
 
 #include <QObject>
+#include <QTemporaryFile>
 #include <QTest>
 
 #include "modeltest.h"
@@ -33,48 +34,171 @@
 #include <models/costmodel.h>
 #include <models/topproxy.h>
 #include <models/callercalleemodel.h>
+#include <models/summarydata.h>
+#include <models/frametable.h>
+#include <models/calltree.h>
+#include <models/callgraph.h>
+#include <models/calledgemodel.h>
+#include <models/profile.h>
+#include <models/stacktable.h>
+#include <models/foldingrule.h>
+#include <models/timebuckettree.h>
+#include <models/samplestore.h>
+#include <models/threadtable.h>
+#include <models/sourcecosttable.h>
+#include <models/sourcecodemodel.h>
+#include <models/stackfolder.h>
+#include <models/chunkmerger.h>
+#include <models/locationtable.h>
+#include <models/callercalleebuilder.h>
+#include <models/parsedinput.h>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
 
 class TestModels : public QObject
 {
     Q_OBJECT
 private:
-    FrameData generateTree(int depth, int breadth, int& id)
-    {
-        FrameData tree;
-        tree.address = "addr" + QString::number(id);
-        tree.binary = "binary" + QString::number(id);
-        tree.symbol = "symbol" + QString::number(id);
-        tree.location = "location" + QString::number(id);
-        tree.selfCost = id;
-        if (depth > 0) {
-            tree.children.reserve(breadth);
-            for (int i = 0; i < breadth; ++i) {
-                tree.children << generateTree(depth - 1, breadth, ++id);
-            }
+    void generateTree(CallTree* tree, int parent, int depth, int breadth, int& id, FrameTable* frames)
+    {
+        if (depth == 0) {
+            return;
+        }
+        for (int i = 0; i < breadth; ++i) {
+            ++id;
+            Frame frame;
+            frame.address = 0x1000 + id;
+            frame.binary = frames->internString("binary" + QString::number(id));
+            frame.symbol = frames->internString("symbol" + QString::number(id));
+            frame.file = frames->internString("file" + QString::number(id));
+            frame.line = id;
+
+            const auto node = tree->addChild(parent, frames->internFrame(frame));
+            tree->addSelfCost(node, id);
+            tree->addCost(node, id, 0);
+            generateTree(tree, node, depth - 1, breadth, id, frames);
         }
-        return tree;
     }
 
-    FrameData generateTree(int depth, int breadth)
+    CallTree generateTree(int depth, int breadth, FrameTable* frames)
     {
+        CallTree tree;
         int id = 0;
-        auto tree = generateTree(depth, breadth, id);
-        FrameData::initializeParents(&tree);
+        generateTree(&tree, CallTree::RootNode, depth, breadth, id, frames);
         return tree;
     }
 
-private slots:
-    void testFrameDataParents()
+    qint32 internFrame(FrameTable* frames, const char* symbol, const char* binary = "app",
+                       quint64 address = 0, qint32 line = -1, bool isKernel = false)
     {
-        auto tree = generateTree(2, 2);
+        Frame frame;
+        frame.symbol = frames->internString(QString::fromLatin1(symbol));
+        frame.binary = frames->internString(QString::fromLatin1(binary));
+        frame.address = address;
+        if (line != -1) {
+            frame.file = frames->internString(QStringLiteral("main.cpp"));
+            frame.line = line;
+        }
+        frame.isKernel = isKernel;
+        return frames->internFrame(frame);
+    }
 
-        QVERIFY(!tree.parent);
-        for (const auto& firstLevel : tree.children) {
-            QVERIFY(!firstLevel.parent);
-            for (const auto& secondLevel : firstLevel.children) {
-                QCOMPARE(secondLevel.parent, &firstLevel);
+    /**
+     * @return the top-down tree of the folded @p stacks, each with the count of its index plus one
+     */
+    CallTree foldedTopDown(StackFolder* folder, const QVector<QVector<qint32>>& stacks)
+    {
+        StackTable table;
+        for (const auto& stack : stacks) {
+            table.addStack(folder->foldStack(stack), -1, table.size() + 1, 0);
+        }
+        CallTree tree;
+        for (int stack = 0; stack < table.size(); ++stack) {
+            table.addToTopDown(&tree, stack);
+        }
+        return tree;
+    }
+
+    /**
+     * @return the indexed stacks that only have the frame of main, each with the count
+     *         of its index in @p counts
+     */
+    StackTable mainStacks(FrameTable* frames, const QVector<quint32>& counts)
+    {
+        const auto mainFrame = internFrame(frames, "main");
+        StackTable stacks;
+        for (auto count : counts) {
+            stacks.addStack({mainFrame}, -1, count, 0);
+        }
+        stacks.indexSymbols(*frames);
+        return stacks;
+    }
+
+    /**
+     * @return the subtrees below @p node as "symbol=inclusive/self", each followed by its children in braces
+     */
+    QString printTree(const CallTree& tree, const FrameTable& frames, int node = CallTree::RootNode)
+    {
+        QStringList children;
+        for (int child = tree.firstChild(node); child != CallTree::InvalidNode; child = tree.nextSibling(child)) {
+            auto text = QStringLiteral("%1=%2/%3").arg(frames.symbol(tree.frameId(child)))
+                .arg(tree.inclusiveCost(child)).arg(tree.selfCost(child));
+            if (tree.firstChild(child) != CallTree::InvalidNode) {
+                text += QLatin1String(" {") + printTree(tree, frames, child) + QLatin1Char('}');
             }
+            children.append(text);
+        }
+        return children.join(QLatin1String(", "));
+    }
+
+private slots:
+    void testCallTree()
+    {
+        CallTree tree;
+        QCOMPARE(tree.size(), 1);
+        QCOMPARE(tree.parent(CallTree::RootNode), int(CallTree::InvalidNode));
+
+        const auto a = tree.addChild(CallTree::RootNode, 1);
+        const auto b = tree.addChild(CallTree::RootNode, 2);
+        QCOMPARE(tree.addChild(CallTree::RootNode, 1), a);
+        const auto c = tree.addChild(a, 2);
+        QVERIFY(c != b);
+        QCOMPARE(tree.parent(c), a);
+        QCOMPARE(tree.firstChild(CallTree::RootNode), a);
+        QCOMPARE(tree.nextSibling(a), b);
+        QCOMPARE(tree.nextSibling(b), int(CallTree::InvalidNode));
+        QCOMPARE(tree.childCount(CallTree::RootNode), 2);
+
+        // wide nodes look up their children through an index
+        const int wideCount = CallTree::MinChildIndexSize + 4;
+        QVector<int> wideChildren;
+        for (int i = 0; i < wideCount; ++i) {
+            wideChildren.append(tree.addChild(b, 100 + i));
         }
+        for (int i = 0; i < wideCount; ++i) {
+            QCOMPARE(tree.addChild(b, 100 + i), wideChildren.at(i));
+        }
+        QCOMPARE(tree.childCount(b), wideCount);
+
+        tree.addCost(c, 3, 1);
+        tree.addSelfCost(c, 2);
+
+        // trees built from chunks of the same stacks share their frame ids
+        CallTree chunk;
+        const auto chunkA = chunk.addChild(CallTree::RootNode, 1);
+        const auto chunkC = chunk.addChild(chunkA, 2);
+        chunk.addCost(chunkC, 5, 5);
+        chunk.addSelfCost(chunkC, 4);
+        chunk.addChild(chunkC, 2);
+
+        tree.merge(chunk);
+        QCOMPARE(tree.childCount(CallTree::RootNode), 2);
+        QCOMPARE(tree.childCount(c), 1);
+        QCOMPARE(tree.inclusiveCost(c), quint32(8));
+        QCOMPARE(tree.kernelCost(c), quint32(6));
+        QCOMPARE(tree.selfCost(c), quint32(6));
     }
 
     void testCostModel()
@@ -82,7 +206,58 @@ private slots:
         CostModel model;
         ModelTest tester(&model);
 
-        model.setData(generateTree(5, 2));
+        FrameTable frames;
+        const auto tree = generateTree(5, 2, &frames);
+        model.setData(tree, frames);
+        QCOMPARE(model.data(model.index(0, CostModel::Symbol, {}), Qt::DisplayRole).toString(),
+                 QStringLiteral("symbol1"));
+        QCOMPARE(model.data(model.index(0, CostModel::Location, {}), Qt::DisplayRole).toString(),
+                 QStringLiteral("file1:1"));
+        QCOMPARE(model.data(model.index(0, CostModel::Address, {}), Qt::DisplayRole).toString(),
+                 QStringLiteral("1001"));
+        QCOMPARE(model.data(model.index(0, CostModel::Address, {}), CostModel::SortRole).toULongLong(),
+                 quint64(0x1001));
+    }
+
+    void testKernelCost()
+    {
+        FrameTable frames;
+        const auto mainFrame = internFrame(&frames, "main");
+        const auto readFrame = internFrame(&frames, "read", "libc.so");
+        const auto vfsReadFrame = internFrame(&frames, "vfs_read", "[kernel.kallsyms]", 0, -1, true);
+        const auto sysReadFrame = internFrame(&frames, "sys_read", "[kernel.kallsyms]", 0, -1, true);
+
+        StackFolder folder(&frames);
+        folder.setCollapseKernelFrames(true);
+        StackTable stacks;
+        // the kernel cost of a stack stems from its innermost frame before it gets folded
+        stacks.addStack(folder.foldStack({vfsReadFrame, sysReadFrame, readFrame, mainFrame}), -1, 3, 3);
+        stacks.addStack(folder.foldStack({readFrame, mainFrame}), -1, 2, 0);
+        CallTree tree;
+        for (int stack = 0; stack < stacks.size(); ++stack) {
+            stacks.addToTopDown(&tree, stack);
+        }
+
+        CostModel model;
+        ModelTest tester(&model);
+        model.setData(tree, frames);
+        auto costs = [&model](const QModelIndex& index) {
+            QVector<int> costs;
+            for (auto column : {CostModel::SelfCost, CostModel::InclusiveCost, CostModel::KernelCost,
+                                CostModel::UserCost}) {
+                costs.append(model.index(index.row(), column, index.parent()).data(CostModel::SortRole).toInt());
+            }
+            return costs;
+        };
+        const auto mainIndex = model.index(0, CostModel::Symbol, {});
+        QCOMPARE(costs(mainIndex), QVector<int>({0, 5, 3, 2}));
+        const auto readIndex = model.index(0, CostModel::Symbol, mainIndex);
+        QCOMPARE(costs(readIndex), QVector<int>({2, 5, 3, 2}));
+        // both kernel frames are collapsed into a single one, which only has kernel cost
+        QCOMPARE(model.rowCount(readIndex), 1);
+        const auto kernelIndex = model.index(0, CostModel::Symbol, readIndex);
+        QCOMPARE(kernelIndex.data().toString(), QStringLiteral("[kernel]"));
+        QCOMPARE(costs(kernelIndex), QVector<int>({3, 3, 3, 0}));
     }
 
     void testTopProxy()
@@ -110,7 +285,991 @@ private slots:
         CallerCalleeModel model;
         ModelTest tester(&model);
 
-        model.setData(generateTree(5, 2));
+        FrameTable frames;
+        const auto tree = generateTree(5, 2, &frames);
+        model.setData(tree, frames);
+    }
+
+    void testCallGraph()
+    {
+        // 1 calls 2 and 3, 2 calls 3
+        const CallGraph graph(4, {{1, 2, 1, 5}, {2, 3, 4, 4}, {1, 3, 2, 2}});
+        QCOMPARE(graph.callerCount(0), 0);
+        QCOMPARE(graph.callerCount(1), 0);
+        QCOMPARE(graph.calleeCount(1), 2);
+        QCOMPARE(graph.callerCount(3), 2);
+        QCOMPARE(graph.calleeCount(3), 0);
+        QCOMPARE(graph.callerCount(4), 0);
+
+        QCOMPARE(graph.callee(2, 0).callee, 3);
+        QCOMPARE(graph.callee(2, 0).inclusiveCost, quint32(4));
+        QCOMPARE(graph.caller(2, 0).caller, 1);
+        QCOMPARE(graph.caller(2, 0).selfCost, quint32(1));
+        quint32 callerCost = 0;
+        for (int i = 0; i < graph.callerCount(3); ++i) {
+            callerCost += graph.caller(3, i).inclusiveCost;
+        }
+        QCOMPARE(callerCost, quint32(6));
+
+        FrameTable frames;
+        const auto tree = generateTree(1, 4, &frames);
+        CallEdgeModel model(CallEdgeModel::Callers);
+        ModelTest tester(&model);
+        model.setData(tree, graph, frames);
+        QCOMPARE(model.rowCount(), 0);
+        model.setFunction(3);
+        QCOMPARE(model.rowCount(), 2);
+        model.setFunction(1);
+        QCOMPARE(model.rowCount(), 0);
+    }
+
+    void testFrameTable()
+    {
+        FrameTable frames;
+        QCOMPARE(frames.internString(QString()), -1);
+        const auto foo = frames.internString(QStringLiteral("foo"));
+        QCOMPARE(frames.internString(QByteArrayLiteral("foo")), foo);
+        QVERIFY(frames.internString(QStringLiteral("fo")) != foo);
+        QCOMPARE(frames.string(foo), QStringLiteral("foo"));
+        const auto umlaut = frames.internString(QStringLiteral("f\u00F6\u00F6"));
+        QCOMPARE(frames.string(umlaut), QStringLiteral("f\u00F6\u00F6"));
+        QVERIFY(frames.string(-1).isEmpty());
+
+        Frame frame;
+        frame.symbol = foo;
+        const auto fooFrame = frames.internFrame(frame);
+        QCOMPARE(frames.internFrame(frame), fooFrame);
+        QCOMPARE(frames.symbol(fooFrame), QStringLiteral("foo"));
+        frame.isKernel = true;
+        QVERIFY(frames.internFrame(frame) != fooFrame);
+        QCOMPARE(frames.frameCount(), 2);
+
+        // only frames of the stacks with a symbol can be filtered by it
+        QVERIFY(frame.isFilterable());
+        QVERIFY(!Frame().isFilterable());
+        Frame process;
+        process.symbol = foo;
+        process.isProcess = true;
+        QVERIFY(!process.isFilterable());
+
+        FrameTable other;
+        Frame barFrame;
+        barFrame.symbol = other.internString(QStringLiteral("bar"));
+        barFrame.binary = other.internString(QStringLiteral("foo"));
+        Frame otherFooFrame;
+        otherFooFrame.symbol = other.internString(QStringLiteral("foo"));
+        const auto otherBar = other.internFrame(barFrame);
+        const auto otherFoo = other.internFrame(otherFooFrame);
+
+        const auto remappedIds = frames.merge(other);
+        QCOMPARE(remappedIds.size(), 2);
+        QCOMPARE(remappedIds.at(otherFoo), fooFrame);
+        QCOMPARE(frames.symbol(remappedIds.at(otherBar)), QStringLiteral("bar"));
+        QCOMPARE(frames.binary(remappedIds.at(otherBar)), QStringLiteral("foo"));
+        QCOMPARE(frames.frameCount(), 3);
+    }
+
+    void testStackTable()
+    {
+        FrameTable frames;
+        auto internFrame = [&frames](const char* symbol) {
+            Frame frame;
+            frame.symbol = frames.internString(QString::fromLatin1(symbol));
+            return frames.internFrame(frame);
+        };
+        const auto mainFrame = internFrame("main");
+        const auto fooFrame = internFrame("foo");
+        const auto barFrame = internFrame("bar");
+        const auto mainSymbol = frames.frame(mainFrame).symbol;
+        const auto fooSymbol = frames.frame(fooFrame).symbol;
+        const auto barSymbol = frames.frame(barFrame).symbol;
+
+        StackTable stacks;
+        stacks.addStack({fooFrame, mainFrame}, -1, 2, 0);
+        stacks.addStack({barFrame, fooFrame, fooFrame, mainFrame}, -1, 3, 1);
+        stacks.addStack({barFrame, mainFrame}, -1, 5, 0);
+        QCOMPARE(stacks.size(), 3);
+        QCOMPARE(stacks.frameCount(1), 4);
+        QCOMPARE(stacks.frameId(1, 0), barFrame);
+
+        stacks.indexSymbols(frames);
+        QCOMPARE(stacks.stacksWithSymbol(mainSymbol), QVector<int>({0, 1, 2}));
+        // recursive frames only get indexed once
+        QCOMPARE(stacks.stacksWithSymbol(fooSymbol), QVector<int>({0, 1}));
+
+        QCOMPARE(stacks.filterStacks({}), QVector<int>({0, 1, 2}));
+        QCOMPARE(stacks.filterStacks({{fooSymbol}, {}}), QVector<int>({0, 1}));
+        QCOMPARE(stacks.filterStacks({{fooSymbol, barSymbol}, {}}), QVector<int>({1}));
+        QCOMPARE(stacks.filterStacks({{}, {fooSymbol}}), QVector<int>({2}));
+        QCOMPARE(stacks.filterStacks({{mainSymbol}, {barSymbol}}), QVector<int>({0}));
+
+        CallTree topDown;
+        CallTree bottomUp;
+        for (auto stack : stacks.filterStacks({{barSymbol}, {}})) {
+            stacks.addToTopDown(&topDown, stack);
+            stacks.addToBottomUp(&bottomUp, stack);
+        }
+        QCOMPARE(topDown.inclusiveCost(CallTree::RootNode), quint32(8));
+        QCOMPARE(topDown.kernelCost(CallTree::RootNode), quint32(1));
+        const auto mainNode = topDown.firstChild(CallTree::RootNode);
+        QCOMPARE(topDown.frameId(mainNode), mainFrame);
+        QCOMPARE(topDown.childCount(mainNode), 2);
+        QCOMPARE(bottomUp.childCount(CallTree::RootNode), 1);
+        QCOMPARE(bottomUp.selfCost(bottomUp.firstChild(CallTree::RootNode)), quint32(8));
+
+        // a part of the samples only gets its share of the kernel cost
+        StackTable kernelStacks;
+        kernelStacks.addStack({barFrame, mainFrame}, -1, 4, 4);
+        kernelStacks.addStack({fooFrame, mainFrame}, -1, 6, 3);
+        CallTree partial;
+        kernelStacks.addToTopDown(&partial, 0, 2);
+        kernelStacks.addToBottomUp(&partial, 1, 4);
+        QCOMPARE(partial.inclusiveCost(CallTree::RootNode), quint32(6));
+        QCOMPARE(partial.kernelCost(CallTree::RootNode), quint32(4));
+
+        StackTable other;
+        other.addStack({0, 1}, 1, 7, 0);
+        stacks.append(other, {barFrame, fooFrame});
+        QCOMPARE(stacks.size(), 4);
+        QCOMPARE(stacks.frameId(3, 0), barFrame);
+        QCOMPARE(stacks.frameId(3, 1), fooFrame);
+        QCOMPARE(stacks.processFrameId(3), fooFrame);
+        QCOMPARE(stacks.count(3), quint32(7));
+    }
+
+    void testStackTrees()
+    {
+        FrameTable frames;
+        const auto mainFrame = internFrame(&frames, "main");
+        const auto fooFrame = internFrame(&frames, "foo");
+        const auto barFrame = internFrame(&frames, "bar");
+        const auto bazFrame = internFrame(&frames, "baz");
+
+        StackTable stacks;
+        stacks.addStack({barFrame, fooFrame, mainFrame}, -1, 1, 0);
+        stacks.addStack({bazFrame, fooFrame, mainFrame}, -1, 2, 0);
+        stacks.addStack({fooFrame, mainFrame}, -1, 3, 0);
+        stacks.addStack({barFrame, mainFrame}, -1, 4, 0);
+        stacks.addStack({mainFrame}, -1, 5, 0);
+        CallTree topDown;
+        CallTree bottomUp;
+        for (int stack = 0; stack < stacks.size(); ++stack) {
+            stacks.addToTopDown(&topDown, stack);
+            stacks.addToBottomUp(&bottomUp, stack);
+        }
+
+        // both trees come from the same pass over the stacks, neither is derived from the other
+        QCOMPARE(printTree(topDown, frames),
+                 QStringLiteral("main=15/5 {foo=6/3 {bar=1/1, baz=2/2}, bar=4/4}"));
+        QCOMPARE(printTree(bottomUp, frames),
+                 QStringLiteral("bar=5/5 {foo=1/0 {main=1/0}, main=4/0}, baz=2/2 {foo=2/0 {main=2/0}}, "
+                                "foo=3/3 {main=3/0}, main=5/5"));
+        QCOMPARE(topDown.inclusiveCost(CallTree::RootNode), bottomUp.inclusiveCost(CallTree::RootNode));
+    }
+
+    void testCallerCalleeBuilder()
+    {
+        FrameTable frames;
+        const auto mainFrame = internFrame(&frames, "main");
+        const auto aFrame = internFrame(&frames, "a", "app", 0x10);
+        // another address in the same function, which shares the entry of a
+        const auto otherAFrame = internFrame(&frames, "a", "app", 0x20);
+        const auto bFrame = internFrame(&frames, "b");
+
+        StackTable stacks;
+        // direct and indirect recursion, every symbol and call must only be counted once per stack
+        stacks.addStack({bFrame, aFrame, otherAFrame, mainFrame}, -1, 2, 0);
+        stacks.addStack({aFrame, bFrame, aFrame, mainFrame}, -1, 3, 3);
+        stacks.addStack({mainFrame}, -1, 1, 0);
+
+        auto printCalls = [&frames](const CallerCalleeBuilder& builder) {
+            const auto& result = builder.result();
+            const auto graph = builder.callGraph();
+            QStringList calls;
+            for (int function = CallTree::RootNode + 1; function < result.size(); ++function) {
+                for (int i = 0; i < graph.calleeCount(function); ++i) {
+                    const auto& edge = graph.callee(function, i);
+                    calls.append(QStringLiteral("%1>%2=%3/%4").arg(frames.symbol(result.frameId(edge.caller)),
+                                                                   frames.symbol(result.frameId(edge.callee)))
+                                     .arg(edge.inclusiveCost).arg(edge.selfCost));
+                }
+            }
+            calls.sort();
+            return calls.join(QLatin1String(", "));
+        };
+
+        CallerCalleeBuilder builder(frames);
+        for (int stack = 0; stack < stacks.size(); ++stack) {
+            builder.addStack(stacks, stack);
+        }
+        QCOMPARE(printTree(builder.result(), frames), QStringLiteral("b=5/2, a=5/3, main=6/1"));
+        QCOMPARE(printCalls(builder), QStringLiteral("a>a=2/0, a>b=5/2, b>a=3/3, main>a=5/0"));
+        const auto mainEntry = builder.result().nextSibling(builder.result().nextSibling(
+            builder.result().firstChild(CallTree::RootNode)));
+        QCOMPARE(builder.result().kernelCost(mainEntry), quint32(3));
+
+        // building the stacks in two parts and merging them yields the same data
+        CallerCalleeBuilder merged(frames);
+        merged.addStack(stacks, 0);
+        CallerCalleeBuilder other(frames);
+        other.addStack(stacks, 1);
+        other.addStack(stacks, 2);
+        merged.merge(other);
+        QCOMPARE(printTree(merged.result(), frames), printTree(builder.result(), frames));
+        QCOMPARE(printCalls(merged), printCalls(builder));
+    }
+
+    void testProcessGrouping()
+    {
+        FrameTable frames;
+        auto processFrame = [&frames](const char* name) {
+            Frame frame;
+            frame.symbol = frames.internString(QString::fromLatin1(name));
+            frame.isProcess = true;
+            return frames.internFrame(frame);
+        };
+        const auto serverFrame = processFrame("server (10)");
+        const auto clientFrame = processFrame("client (20)");
+        const auto mainFrame = internFrame(&frames, "main");
+        const auto mallocFrame = internFrame(&frames, "malloc", "libc.so");
+
+        StackTable stacks;
+        stacks.addStack({mallocFrame, mainFrame}, serverFrame, 2, 0);
+        stacks.addStack({mainFrame}, serverFrame, 3, 0);
+        stacks.addStack({mallocFrame, mainFrame}, clientFrame, 4, 0);
+        CallTree topDown;
+        CallTree bottomUp;
+        for (int stack = 0; stack < stacks.size(); ++stack) {
+            stacks.addToTopDown(&topDown, stack);
+            stacks.addToBottomUp(&bottomUp, stack);
+        }
+
+        // every process has its own top level node, in both trees
+        for (const auto* tree : {&topDown, &bottomUp}) {
+            QCOMPARE(tree->childCount(CallTree::RootNode), 2);
+            QCOMPARE(tree->inclusiveCost(CallTree::RootNode), quint32(9));
+            const auto serverNode = tree->firstChild(CallTree::RootNode);
+            QCOMPARE(tree->frameId(serverNode), serverFrame);
+            QCOMPARE(tree->inclusiveCost(serverNode), quint32(5));
+            QCOMPARE(tree->selfCost(serverNode), quint32(0));
+            const auto clientNode = tree->nextSibling(serverNode);
+            QCOMPARE(tree->frameId(clientNode), clientFrame);
+            QCOMPARE(tree->inclusiveCost(clientNode), quint32(4));
+        }
+
+        // the same frames of different processes are not conflated
+        const auto serverMain = topDown.firstChild(topDown.firstChild(CallTree::RootNode));
+        QCOMPARE(topDown.frameId(serverMain), mainFrame);
+        QCOMPARE(topDown.inclusiveCost(serverMain), quint32(5));
+        QCOMPARE(topDown.selfCost(serverMain), quint32(3));
+        const auto clientMalloc = bottomUp.firstChild(bottomUp.nextSibling(bottomUp.firstChild(CallTree::RootNode)));
+        QCOMPARE(bottomUp.frameId(clientMalloc), mallocFrame);
+        QCOMPARE(bottomUp.selfCost(clientMalloc), quint32(4));
+        QCOMPARE(bottomUp.childCount(clientMalloc), 1);
+    }
+
+    void testTimeBucketTree()
+    {
+        TimeBucketTree timeline(10);
+        timeline.addSample(100, 0);
+        timeline.addSample(101, 0);
+        timeline.addSample(105, 1);
+        timeline.addSample(125, 0);
+        timeline.addSample(150, 2);
+        timeline.addSample(199, 1);
+        timeline.build();
+
+        auto toString = [](const QVector<StackCount>& counts) {
+            QStringList result;
+            for (const auto& count : counts) {
+                result.append(QStringLiteral("%1:%2").arg(count.stack).arg(count.count));
+            }
+            return result.join(QLatin1Char(' '));
+        };
+        QCOMPARE(toString(timeline.stackCounts(0, 1000)), QStringLiteral("0:3 1:2 2:1"));
+        QCOMPARE(toString(timeline.stackCounts(100, 109)), QStringLiteral("0:2 1:1"));
+        // all buckets that overlap the range are included
+        QCOMPARE(toString(timeline.stackCounts(115, 155)), QStringLiteral("0:1 2:1"));
+        QCOMPARE(toString(timeline.stackCounts(160, 180)), QString());
+        QCOMPARE(toString(timeline.stackCounts(195, 1000)), QStringLiteral("1:1"));
+        QCOMPARE(toString(timeline.stackCounts(0, 50)), QString());
+
+        // samples of the same stack in a bucket are counted once they are added
+        TimeBucketTree repeated(10);
+        for (int i = 0; i < 1000; ++i) {
+            repeated.addSample(100 + i % 10, i % 2);
+        }
+        repeated.build();
+        QCOMPARE(toString(repeated.stackCounts(0, 1000)), QStringLiteral("0:500 1:500"));
+
+        // an outlier makes the buckets coarser instead of allocating a bucket for every 10ns
+        TimeBucketTree outlier(10);
+        outlier.addSample(5, 0);
+        outlier.addSample(15, 1);
+        outlier.addSample(quint64(30) * TimeBucketTree::MaxBucketCount + 5, 2);
+        outlier.build();
+        QCOMPARE(outlier.bucketSize(), quint64(40));
+        QCOMPARE(toString(outlier.stackCounts(0, 39)), QStringLiteral("0:1 1:1"));
+        QCOMPARE(toString(outlier.stackCounts(40, quint64(30) * TimeBucketTree::MaxBucketCount)),
+                 QStringLiteral("2:1"));
+
+        FrameTable frames;
+        const auto stacks = mainStacks(&frames, {3, 2, 1});
+        const auto profile = Profile().withStacks(stacks).withTimeline(timeline);
+        StackFilter filter;
+        filter.startTime = 100;
+        filter.endTime = 129;
+        const auto filtered = profile.filtered(filter);
+        QCOMPARE(filtered.topDown().inclusiveCost(CallTree::RootNode), quint32(4));
+        filter.excludedSymbols = {frames.frame(stacks.frameId(0, 0)).symbol};
+        QCOMPARE(profile.filtered(filter).bottomUp().inclusiveCost(CallTree::RootNode), quint32(0));
+    }
+
+    void testMergedTimeRanges()
+    {
+        // every sample is a pair of its time and the symbol of its stack
+        using Samples = QVector<QPair<quint64, const char*>>;
+        auto parsedInput = [this](quint64 startTime, const Samples& samples) {
+            ParsedInput input;
+            input.timeline = TimeBucketTree(10);
+            input.summaryResult.applicationStartTime = startTime;
+            // every stack only has the frame of its symbol
+            QVector<qint32> stackFrames;
+            QVector<quint32> counts;
+            for (const auto& sample : samples) {
+                const auto frame = internFrame(&input.frameTable, sample.second);
+                auto stack = stackFrames.indexOf(frame);
+                if (stack == -1) {
+                    stack = stackFrames.size();
+                    stackFrames.append(frame);
+                    counts.append(0);
+                }
+                ++counts[stack];
+                input.timeline.addSample(sample.first, stack);
+                input.sampleStore.addSample({sample.first, 1, 1, stack, 0});
+            }
+            for (int stack = 0; stack < stackFrames.size(); ++stack) {
+                input.stackTable.addStack({stackFrames.at(stack)}, -1, counts.at(stack), 0);
+            }
+            return input;
+        };
+
+        const Samples firstSamples = {{100, "a"}, {103, "b"}, {108, "a"}, {111, "b"}, {117, "a"},
+                                      {122, "b"}, {126, "a"}, {134, "b"}, {139, "a"}, {145, "b"}};
+        const Samples secondSamples = {{2000, "c"}, {2004, "b"}, {2009, "c"}, {2013, "b"},
+                                       {2018, "c"}, {2021, "b"}, {2027, "c"}};
+        auto merged = parsedInput(100, firstSamples);
+        // the second input gets aligned by 1885, which is not a multiple of the bucket size
+        merged.merge(parsedInput(1985, secondSamples));
+        merged.timeline.build();
+        merged.stackTable.indexSymbols(merged.frameTable);
+        const auto profile = Profile().withStacks(merged.stackTable).withTimeline(merged.timeline)
+                                      .withSamples(merged.sampleStore);
+
+        Samples allSamples = firstSamples;
+        for (const auto& sample : secondSamples) {
+            allSamples.append({sample.first - 1885, sample.second});
+        }
+        for (quint64 startTime = 95; startTime <= 150; ++startTime) {
+            for (quint64 endTime = startTime; endTime <= 150; endTime += 3) {
+                QMap<QString, quint32> expected;
+                for (const auto& sample : allSamples) {
+                    if (sample.first >= startTime && sample.first <= endTime) {
+                        ++expected[QString::fromLatin1(sample.second)];
+                    }
+                }
+
+                StackFilter filter;
+                filter.startTime = startTime;
+                filter.endTime = endTime;
+                const auto topDown = profile.filtered(filter).topDown();
+                QMap<QString, quint32> actual;
+                for (int child = topDown.firstChild(CallTree::RootNode); child != CallTree::InvalidNode;
+                     child = topDown.nextSibling(child)) {
+                    actual[merged.frameTable.symbol(topDown.frameId(child))] += topDown.inclusiveCost(child);
+                }
+                QCOMPARE(actual, expected);
+            }
+        }
+    }
+
+    void testSampleStore()
+    {
+        SampleStore store;
+        const quint64 startTime = 1000000000000;
+        for (int i = 0; i < 2 * SampleStore::BlockSize + 10; ++i) {
+            // the samples of different threads can arrive slightly out of order
+            const auto time = startTime + i * 1000 + (i % 2 ? 0 : 1500);
+            store.addSample({time, 1, quint32(1 + i % 3), i % 7, i % 2});
+        }
+        QCOMPARE(store.size(), 2 * SampleStore::BlockSize + 10);
+        QCOMPARE(store.blockCount(), 3);
+
+        auto samples = store.samples();
+        QCOMPARE(samples.size(), store.size());
+        for (int i = 0; i < samples.size(); ++i) {
+            const auto& sample = samples.at(i);
+            QCOMPARE(sample.time, startTime + i * 1000 + (i % 2 ? 0 : 1500));
+            QCOMPARE(sample.pid, quint32(1));
+            QCOMPARE(sample.tid, quint32(1 + i % 3));
+            QCOMPARE(sample.stack, i % 7);
+            QCOMPARE(sample.attribute, i % 2);
+        }
+
+        samples = store.samples(startTime + 1000, startTime + 4000);
+        QCOMPARE(samples.size(), 4);
+        QCOMPARE(samples.at(0).time, startTime + 1500);
+        QCOMPARE(samples.at(1).time, startTime + 1000);
+        QCOMPARE(samples.at(2).time, startTime + 3500);
+        QCOMPARE(samples.at(3).time, startTime + 3000);
+        QVERIFY(store.samples(0, startTime - 1).isEmpty());
+
+        // samples every millisecond with some jitter, of three threads and one attribute
+        SampleStore realistic;
+        for (int i = 0; i < 2 * SampleStore::BlockSize; ++i) {
+            const auto time = startTime + i * quint64(1000000) + (i * 7919) % 20000;
+            realistic.addSample({time, 1, quint32(1 + i % 3), (i * 31) % 50, i < 10 ? 1 : 0});
+        }
+        QVERIFY(realistic.byteSize() < 11 * realistic.size() / 2);
+        QCOMPARE(realistic.samples().at(9).attribute, 1);
+        QCOMPARE(realistic.samples().at(10).attribute, 0);
+        QCOMPARE(realistic.samples().last().stack, (2 * SampleStore::BlockSize - 1) * 31 % 50);
+
+        SampleStore merged;
+        merged.addSample({10, 2, 2, 0, 0});
+        // the second sample of the store gets aligned with the first one of merged
+        merged.merge(store, 1, 10 - qint64(startTime + 1000));
+        QCOMPARE(merged.size(), store.size() + 1);
+        samples = merged.samples(10, 10);
+        QCOMPARE(samples.size(), 2);
+        QCOMPARE(samples.at(1).tid, quint32(2));
+        QCOMPARE(samples.at(1).stack, 2);
+
+        // the edges of a time range that do not cover a whole bucket come from the samples
+        TimeBucketTree timeline(10);
+        SampleStore timelineSamples;
+        for (quint64 time : {100, 105, 112, 118, 125, 131}) {
+            timeline.addSample(time, qint32(time % 2));
+            timelineSamples.addSample({time, 1, 1, qint32(time % 2), 0});
+        }
+        timeline.build();
+        FrameTable frames;
+        const auto profile = Profile().withStacks(mainStacks(&frames, {3, 3}))
+            .withTimeline(timeline).withSamples(timelineSamples);
+        StackFilter filter;
+        filter.startTime = 104;
+        filter.endTime = 126;
+        QCOMPARE(profile.filtered(filter).topDown().inclusiveCost(CallTree::RootNode), quint32(4));
+        filter.startTime = 113;
+        filter.endTime = 118;
+        QCOMPARE(profile.filtered(filter).topDown().inclusiveCost(CallTree::RootNode), quint32(1));
+        filter.startTime = 110;
+        filter.endTime = 131;
+        QCOMPARE(profile.filtered(filter).topDown().inclusiveCost(CallTree::RootNode), quint32(4));
+    }
+
+    void testThreadTable()
+    {
+        ThreadTable threads;
+        const auto mainThread = threads.addThread(1, 1, QStringLiteral("server"));
+        const auto workerThread = threads.addThread(1, 2, QStringLiteral("worker"));
+        threads.addStack(mainThread, 0, 2);
+        threads.addStack(workerThread, 1, 3);
+        threads.addStack(mainThread, 2, 5);
+        QCOMPARE(threads.size(), 2);
+        QCOMPARE(threads.sampleCount(mainThread), quint64(7));
+        QCOMPARE(threads.name(workerThread), QStringLiteral("worker"));
+
+        auto counts = threads.stackCounts({workerThread, mainThread});
+        QCOMPARE(counts.size(), 3);
+        QCOMPARE(counts.at(1).stack, 1);
+        QCOMPARE(counts.at(1).count, quint32(3));
+
+        ThreadTable other;
+        other.addStack(other.addThread(1, 1, QStringLiteral("client")), 0, 4);
+        threads.append(other, 3);
+        QCOMPARE(threads.size(), 3);
+        QCOMPARE(threads.tid(2), quint32(1));
+        counts = threads.stackCounts(2);
+        QCOMPARE(counts.size(), 1);
+        QCOMPARE(counts.at(0).stack, 3);
+
+        FrameTable frames;
+        QVector<quint32> stackCounts;
+        for (const auto& count : threads.stackCounts({0, 1, 2})) {
+            stackCounts.append(count.count);
+        }
+        const auto profile = Profile().withStacks(mainStacks(&frames, stackCounts)).withThreads(threads);
+        StackFilter filter;
+        filter.threads = {mainThread, 2};
+        QCOMPARE(profile.filtered(filter).topDown().inclusiveCost(CallTree::RootNode), quint32(11));
+    }
+
+    void testSourceCostTable()
+    {
+        SourceCostTable costs;
+        costs.addLineCosts(QStringLiteral("main.cpp"), {{12, 1, 4}, {3, 0, 4}});
+        costs.addLineCosts(QStringLiteral("foo.cpp"), {{7, 2, 2}});
+
+        SourceCostTable other;
+        other.addLineCosts(QStringLiteral("main.cpp"), {{12, 2, 2}, {5, 1, 1}});
+        costs.merge(other);
+        QCOMPARE(costs.files().size(), 2);
+
+        const auto lines = costs.lineCosts(QStringLiteral("main.cpp"));
+        QCOMPARE(lines.size(), 3);
+        QCOMPARE(lines.at(0).line, 3);
+        QCOMPARE(lines.at(1).line, 5);
+        QCOMPARE(lines.at(2).line, 12);
+        QCOMPARE(lines.at(2).selfCost, quint64(3));
+        QCOMPARE(lines.at(2).inclusiveCost, quint64(6));
+        QVERIFY(costs.lineCosts(QStringLiteral("bar.cpp")).isEmpty());
+    }
+
+    void testSourceCodeModel()
+    {
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        file.write("int main()\r\n{\n    return 0;\n}");
+        file.close();
+
+        SourceCodeModel model;
+        ModelTest tester(&model);
+
+        QVERIFY(model.setSource(file.fileName(), {{3, 1, 2}}));
+        QCOMPARE(model.rowCount(), 4);
+        QCOMPARE(model.data(model.index(0, SourceCodeModel::Code), Qt::DisplayRole).toString(),
+                 QStringLiteral("int main()"));
+        QCOMPARE(model.data(model.index(3, SourceCodeModel::Code), Qt::DisplayRole).toString(),
+                 QStringLiteral("}"));
+        QCOMPARE(model.data(model.index(2, SourceCodeModel::LineNumber), Qt::DisplayRole).toInt(), 3);
+        QCOMPARE(model.data(model.index(2, SourceCodeModel::InclusiveCost), Qt::DisplayRole).toULongLong(),
+                 quint64(2));
+        QVERIFY(!model.data(model.index(1, SourceCodeModel::SelfCost), Qt::DisplayRole).isValid());
+        QCOMPARE(model.rowForLine(10), 3);
+
+        QVERIFY(!model.setSource(QStringLiteral("/does/not/exist.cpp"), {}));
+        QCOMPARE(model.rowCount(), 0);
+    }
+
+    void testFrameAggregation()
+    {
+        FrameTable frames;
+        const auto main5a = internFrame(&frames, "main", "app", 0x10, 5);
+        const auto main5b = internFrame(&frames, "main", "app", 0x14, 5);
+        const auto main6 = internFrame(&frames, "main", "app", 0x20, 6);
+        const auto foo = internFrame(&frames, "foo", "libfoo", 0x100, 10);
+        const auto bar = internFrame(&frames, "bar", "libfoo", 0x200, 20);
+        const QVector<QVector<qint32>> stacks = {{bar, foo, main5a}, {bar, foo, main5b}, {foo, main6}};
+
+        const auto aggregated = aggregateFrame(frames.frame(main5a), FrameAggregation::Function);
+        QCOMPARE(aggregated.address, quint64(0));
+        QCOMPARE(aggregated.line, -1);
+        QCOMPARE(aggregated.symbol, frames.frame(main5a).symbol);
+        // the file is kept, so that the source of a function can still be shown
+        QCOMPARE(aggregated.file, frames.frame(main5a).file);
+        QCOMPARE(aggregateFrame(frames.frame(main5a), FrameAggregation::Binary).file, -1);
+
+        // the number of nodes below the root for every aggregation
+        const QVector<QPair<FrameAggregation, int>> nodeCounts = {
+            {FrameAggregation::Address, 8},
+            {FrameAggregation::SourceLine, 5},
+            {FrameAggregation::Function, 3},
+            {FrameAggregation::Binary, 2}
+        };
+        for (const auto& nodeCount : nodeCounts) {
+            StackFolder folder(&frames);
+            folder.setAggregation(nodeCount.first);
+            const auto tree = foldedTopDown(&folder, stacks);
+            QCOMPARE(tree.size() - 1, nodeCount.second);
+            QCOMPARE(tree.inclusiveCost(CallTree::RootNode), quint32(6));
+
+            const auto mainNode = tree.firstChild(CallTree::RootNode);
+            if (nodeCount.first == FrameAggregation::Function) {
+                QCOMPARE(tree.inclusiveCost(mainNode), quint32(6));
+                QCOMPARE(tree.childCount(tree.firstChild(mainNode)), 1);
+            } else if (nodeCount.first == FrameAggregation::Binary) {
+                // foo and bar are consecutive frames of libfoo, so they become a single frame
+                QCOMPARE(frames.symbol(tree.frameId(mainNode)), QStringLiteral("app"));
+                const auto libfooNode = tree.firstChild(mainNode);
+                QCOMPARE(frames.symbol(tree.frameId(libfooNode)), QStringLiteral("libfoo"));
+                QCOMPARE(tree.selfCost(libfooNode), quint32(6));
+                QCOMPARE(tree.childCount(libfooNode), 0);
+            }
+        }
+    }
+
+    void testLocationTable()
+    {
+        FrameTable frames;
+        const auto app = frames.internString(QStringLiteral("app"));
+        const auto mainCpp = frames.internString(QStringLiteral("main.cpp"));
+        LocationTable locations(&frames);
+        locations.addLocation(-1, 0x10, mainCpp, 3, -1);
+        // a function entry point without a symbol, it stands in for its parent
+        locations.addLocation(2, 0x20, -1, -1, -1);
+        locations.addLocation(-1, 0x30, -1, -1, -1);
+        // inlined into main
+        locations.addLocation(0, 0x40, mainCpp, 7, 2);
+        locations.setSymbol(0, frames.internString(QStringLiteral("main")), app, false);
+        locations.setSymbol(2, frames.internString(QStringLiteral("foo")), app, false);
+        locations.setSymbol(3, frames.internString(QStringLiteral("bar")), app, false);
+        QCOMPARE(locations.size(), 4);
+
+        auto toString = [&frames](const QVector<qint32>& frameIds) {
+            QStringList result;
+            for (auto frameId : frameIds) {
+                result.append(frames.symbol(frameId) + QLatin1Char('@') + frames.address(frameId)
+                              + QLatin1Char(' ') + frames.location(frameId));
+            }
+            return result.join(QLatin1String(", "));
+        };
+        QCOMPARE(toString(locations.framesForLocation(3)), QStringLiteral("bar@40 main.cpp:7, main@10 main.cpp:3"));
+        QCOMPARE(toString(locations.framesForLocation(1)), QStringLiteral("foo@20 "));
+        QVERIFY(locations.framesForLocation(4).isEmpty());
+        QVERIFY(locations.framesForLocation(-1).isEmpty());
+
+        // the resolved frames are cached, also when more locations get added
+        const auto frameCount = frames.frameCount();
+        locations.addLocation(3, 0x50, -1, -1, -1);
+        locations.setSymbol(4, frames.internString(QStringLiteral("baz")), app, false);
+        QCOMPARE(toString(locations.framesForLocation(3)), QStringLiteral("bar@40 main.cpp:7, main@10 main.cpp:3"));
+        QCOMPARE(frames.frameCount(), frameCount);
+        QCOMPARE(toString(locations.framesForLocation(4)),
+                 QStringLiteral("baz@50 , bar@40 main.cpp:7, main@10 main.cpp:3"));
+    }
+
+    void testFoldingRule()
+    {
+        FoldingRule rule;
+        QVERIFY(FoldingRule::fromString(QStringLiteral("collapse symbol ^std::"), &rule));
+        QCOMPARE(rule.action, FoldingRule::CollapseIntoCaller);
+        QCOMPARE(rule.target, FoldingRule::Symbol);
+        QVERIFY(rule.matches(QStringLiteral("std::vector<int>::push_back"), QStringLiteral("libfoo.so")));
+        QVERIFY(!rule.matches(QStringLiteral("foo::std::bar"), QStringLiteral("libfoo.so")));
+        QCOMPARE(rule.toString(), QStringLiteral("collapse symbol ^std::"));
+
+        QVERIFY(FoldingRule::fromString(QStringLiteral("  merge binary libQt5Core\\.so|libc -> [qt core] "), &rule));
+        QCOMPARE(rule.action, FoldingRule::MergeIntoFrame);
+        QCOMPARE(rule.target, FoldingRule::Binary);
+        QCOMPARE(rule.frameName, QStringLiteral("[qt core]"));
+        QVERIFY(rule.matches(QStringLiteral("main"), QStringLiteral("libQt5Core.so.5")));
+        QCOMPARE(rule.toString(), QStringLiteral("merge binary libQt5Core\\.so|libc -> [qt core]"));
+
+        QVERIFY(!FoldingRule::fromString(QStringLiteral("collapse"), &rule));
+        QVERIFY(!FoldingRule::fromString(QStringLiteral("fold symbol foo"), &rule));
+        QVERIFY(!FoldingRule::fromString(QStringLiteral("collapse file foo"), &rule));
+        QVERIFY(!FoldingRule::fromString(QStringLiteral("merge symbol foo"), &rule));
+        QVERIFY(!FoldingRule::fromString(QStringLiteral("collapse symbol (foo"), &rule));
+    }
+
+    void testStackFolding()
+    {
+        FrameTable frames;
+        const auto mainFrame = internFrame(&frames, "main");
+        const auto execFrame = internFrame(&frames, "QCoreApplication::exec", "libQt5Core.so");
+        const auto loopFrame = internFrame(&frames, "QEventLoop::exec", "libQt5Core.so");
+        const auto sortFrame = internFrame(&frames, "std::sort");
+        const auto readFrame = internFrame(&frames, "sys_read", "[kernel.kallsyms]", 0, -1, true);
+
+        QVector<FoldingRule> rules;
+        for (const auto text : {"collapse symbol ^std::", "merge binary libQt5Core -> [qt]", "merge symbol ^sys_ -> [syscall]"}) {
+            FoldingRule rule;
+            QVERIFY(FoldingRule::fromString(QString::fromLatin1(text), &rule));
+            rules.append(rule);
+        }
+
+        StackFolder folder(&frames);
+        folder.setFoldingRules(rules);
+        // std::sort gets collapsed, both Qt frames are merged into a single one
+        auto folded = folder.foldStack({readFrame, sortFrame, loopFrame, execFrame, mainFrame});
+        QCOMPARE(folded.size(), 3);
+        QCOMPARE(frames.symbol(folded.at(0)), QStringLiteral("[syscall]"));
+        QCOMPARE(frames.symbol(folded.at(1)), QStringLiteral("[qt]"));
+        QCOMPARE(folded.at(2), mainFrame);
+        // merged frames keep their binary and kernel space
+        QVERIFY(frames.frame(folded.at(0)).isKernel);
+        QCOMPARE(frames.binary(folded.at(0)), QStringLiteral("[kernel.kallsyms]"));
+        QCOMPARE(frames.binary(folded.at(1)), QStringLiteral("libQt5Core.so"));
+
+        // only consecutive frames of the same rule are merged
+        folded = folder.foldStack({loopFrame, readFrame, execFrame, mainFrame});
+        QCOMPARE(folded.size(), 4);
+
+        folder.setCollapseKernelFrames(true);
+        folded = folder.foldStack({readFrame, sortFrame, loopFrame, execFrame, mainFrame});
+        QCOMPARE(folded.size(), 3);
+        QCOMPARE(frames.symbol(folded.at(0)), QStringLiteral("[kernel]"));
+        QVERIFY(frames.frame(folded.at(0)).isKernel);
+    }
+
+    void testRecursionFolding()
+    {
+        FrameTable frames;
+        const auto mainFrame = internFrame(&frames, "main");
+        const auto aFrame = internFrame(&frames, "a");
+        const auto bFrame = internFrame(&frames, "b");
+        const auto cFrame = internFrame(&frames, "c");
+        const auto unknownFrame = frames.internFrame(Frame());
+
+        auto recursiveFrames = [&frames](const QVector<qint32>& stack) {
+            QVector<int> indices;
+            const auto bits = findRecursiveFrames(frames, stack);
+            for (int i = 0; i < bits.size(); ++i) {
+                if (bits.testBit(i)) {
+                    indices.append(i);
+                }
+            }
+            return indices;
+        };
+
+        // direct recursion: main > a > a > a
+        QCOMPARE(recursiveFrames({aFrame, aFrame, aFrame, mainFrame}), QVector<int>({1, 2}));
+        // the cycle main > a > b > a > b > c becomes main > a > b > c
+        QCOMPARE(recursiveFrames({cFrame, bFrame, aFrame, bFrame, aFrame, mainFrame}), QVector<int>({3, 4}));
+        // no frame inside the cycle gets lost: main > a > b > a > c becomes main > b > a > c
+        QCOMPARE(recursiveFrames({cFrame, aFrame, bFrame, aFrame, mainFrame}), QVector<int>({3}));
+        // frames without a symbol are never recursive
+        QCOMPARE(recursiveFrames({unknownFrame, aFrame, unknownFrame, mainFrame}), QVector<int>());
+
+        StackTable stacks;
+        const QVector<qint32> stack = {cFrame, aFrame, bFrame, aFrame, mainFrame};
+        stacks.addStack(stack, -1, 2, 0, findRecursiveFrames(frames, stack));
+        // the stack keeps all of its frames for the other views
+        QCOMPARE(stacks.frameCount(0), 5);
+        QVERIFY(stacks.isRecursive(0, 3));
+        QVERIFY(!stacks.isRecursive(0, 1));
+
+        CallTree topDown;
+        stacks.addToTopDown(&topDown, 0);
+        QCOMPARE(topDown.size(), 5);
+        auto node = topDown.firstChild(CallTree::RootNode);
+        for (auto frameId : {mainFrame, bFrame, aFrame, cFrame}) {
+            QCOMPARE(topDown.frameId(node), frameId);
+            QCOMPARE(topDown.inclusiveCost(node), quint32(2));
+            QCOMPARE(topDown.childCount(node), frameId == cFrame ? 0 : 1);
+            node = topDown.firstChild(node);
+        }
+
+        // the folded tree has the call main > b, which never happened
+        QCOMPARE(printTree(topDown, frames), QStringLiteral("main=2/0 {b=2/0 {a=2/0 {c=2/2}}}"));
+        CallerCalleeBuilder callerCallee(frames);
+        callerCallee.addStack(stacks, 0);
+        const auto& entries = callerCallee.result();
+        const auto graph = callerCallee.callGraph();
+        QStringList mainCallees;
+        for (int entry = entries.firstChild(CallTree::RootNode); entry != CallTree::InvalidNode;
+             entry = entries.nextSibling(entry)) {
+            if (entries.frameId(entry) != mainFrame) {
+                continue;
+            }
+            for (int i = 0; i < graph.calleeCount(entry); ++i) {
+                mainCallees.append(frames.symbol(entries.frameId(graph.callee(entry, i).callee)));
+            }
+        }
+        // the caller-callee data only has the real calls of main
+        QCOMPARE(mainCallees, QStringList({QStringLiteral("a")}));
+
+        CallTree bottomUp;
+        stacks.addToBottomUp(&bottomUp, 0);
+        QCOMPARE(bottomUp.size(), 5);
+        const auto cNode = bottomUp.firstChild(CallTree::RootNode);
+        QCOMPARE(bottomUp.frameId(cNode), cFrame);
+        QCOMPARE(bottomUp.selfCost(cNode), quint32(2));
+
+        // appending keeps the recursive frames
+        StackTable appended;
+        appended.addStack({mainFrame}, -1, 1, 0);
+        QVector<qint32> remappedIds(frames.frameCount());
+        std::iota(remappedIds.begin(), remappedIds.end(), 0);
+        appended.append(stacks, remappedIds);
+        QVERIFY(appended.isRecursive(1, 3));
+        QVERIFY(!appended.isRecursive(1, 2));
+    }
+
+    void testChunkMerger()
+    {
+        // the stacks share some of their frames, so that the chunks create overlapping nodes
+        StackTable stacks;
+        for (int i = 0; i < 11; ++i) {
+            stacks.addStack({qint32(i % 4), qint32(i % 3), 0}, -1, quint32(i + 1), i % 2 ? quint32(i + 1) : 0);
+        }
+        auto build = [&stacks](int begin, int end) {
+            auto tree = std::make_unique<CallTree>();
+            for (int stack = begin; stack < end; ++stack) {
+                stacks.addToTopDown(tree.get(), stack);
+            }
+            return tree;
+        };
+        const auto singlePass = build(0, stacks.size());
+
+        // six chunks of two stacks, the last one only has one
+        const int chunkSize = 2;
+        const auto orders = {QVector<int>{0, 1, 2, 3, 4, 5}, QVector<int>{5, 4, 3, 2, 1, 0},
+                             QVector<int>{3, 1, 5, 0, 4, 2}};
+        for (const auto& order : orders) {
+            ChunkMerger<CallTree> merger(6);
+            std::unique_ptr<CallTree> merged;
+            for (auto chunk : order) {
+                QVERIFY(!merged);
+                const auto begin = chunk * chunkSize;
+                merged = merger.addChunk(chunk, build(begin, std::min(begin + chunkSize, stacks.size())),
+                                         [](CallTree* tree, const CallTree& other) { tree->merge(other); });
+            }
+            // the chunks get merged in their order, no matter in which order they finish
+            QVERIFY(merged);
+            QCOMPARE(merged->size(), singlePass->size());
+            for (int node = 0; node < singlePass->size(); ++node) {
+                QCOMPARE(merged->frameId(node), singlePass->frameId(node));
+                QCOMPARE(merged->parent(node), singlePass->parent(node));
+                QCOMPARE(merged->inclusiveCost(node), singlePass->inclusiveCost(node));
+                QCOMPARE(merged->selfCost(node), singlePass->selfCost(node));
+                QCOMPARE(merged->kernelCost(node), singlePass->kernelCost(node));
+            }
+        }
+    }
+
+    void testLostIntervals()
+    {
+        SummaryData summary;
+        summary.lostIntervals = SummaryData::mergeLostEvents({50, 10, 12, 100, 15, 52}, 5);
+
+        QCOMPARE(summary.lostIntervals.size(), 3);
+        QCOMPARE(summary.lostIntervals[0].startTime, quint64(10));
+        QCOMPARE(summary.lostIntervals[0].endTime, quint64(15));
+        QCOMPARE(summary.lostIntervals[0].chunks, quint64(3));
+        QCOMPARE(summary.lostIntervals[1].startTime, quint64(50));
+        QCOMPARE(summary.lostIntervals[1].endTime, quint64(52));
+        QCOMPARE(summary.lostIntervals[1].chunks, quint64(2));
+        QCOMPARE(summary.lostIntervals[2].startTime, quint64(100));
+        QCOMPARE(summary.lostIntervals[2].chunks, quint64(1));
+
+        QCOMPARE(summary.lostChunksInRange(0, 9), quint64(0));
+        QCOMPARE(summary.lostChunksInRange(0, 10), quint64(3));
+        QCOMPARE(summary.lostChunksInRange(16, 49), quint64(0));
+        QCOMPARE(summary.lostChunksInRange(14, 51), quint64(5));
+        QCOMPARE(summary.lostChunksInRange(53, 1000), quint64(1));
+    }
+
+    void testParsedInputMerge()
+    {
+        // both inputs have a process with pid 1 and their samples start with main
+        auto addProcess = [](ParsedInput* input, const char* path) {
+            Frame process;
+            process.symbol = input->frameTable.internString(QStringLiteral("app (1)"));
+            process.file = input->frameTable.internString(QString::fromLatin1(path));
+            process.isProcess = true;
+            const auto thread = input->threadTable.addThread(1, 1, QStringLiteral("app"));
+            return qMakePair(input->frameTable.internFrame(process), thread);
+        };
+
+        ParsedInput first;
+        const auto firstProcess = addProcess(&first, "first.data");
+        const auto mainFrame = internFrame(&first.frameTable, "main");
+        const auto fooFrame = internFrame(&first.frameTable, "foo");
+        first.stackTable.addStack({mainFrame}, firstProcess.first, 1, 0);
+        first.stackTable.addStack({fooFrame, mainFrame}, firstProcess.first, 1, 0);
+        for (auto sample : {qMakePair(1000, 0), qMakePair(1005, 1)}) {
+            first.timeline.addSample(sample.first, sample.second);
+            first.sampleStore.addSample({quint64(sample.first), 1, 1, sample.second, 0});
+            first.threadTable.addStack(firstProcess.second, sample.second, 1);
+        }
+        first.lostTimes = {1002};
+        first.summaryResult.applicationStartTime = 1000;
+        first.summaryResult.applicationRunningTime = 10;
+        first.summaryResult.sampleCount = 2;
+        first.summaryResult.threadCount = 1;
+        first.summaryResult.processCount = 1;
+        first.summaryResult.lostChunks = 1;
+        first.summaryResult.command = QStringLiteral("perf record ./app");
+
+        // the frames of the second input are interned in a different order
+        ParsedInput second;
+        const auto secondProcess = addProcess(&second, "second.data");
+        const auto secondFoo = internFrame(&second.frameTable, "foo");
+        const auto secondMain = internFrame(&second.frameTable, "main");
+        second.stackTable.addStack({secondFoo, secondMain}, secondProcess.first, 1, 0);
+        second.stackTable.addStack({secondMain}, secondProcess.first, 1, 0);
+        for (auto sample : {qMakePair(5000, 0), qMakePair(5020, 1)}) {
+            second.timeline.addSample(sample.first, sample.second);
+            second.sampleStore.addSample({quint64(sample.first), 1, 1, sample.second, 0});
+            second.threadTable.addStack(secondProcess.second, sample.second, 1);
+        }
+        second.lostTimes = {5010};
+        second.summaryResult.applicationStartTime = 5000;
+        second.summaryResult.applicationRunningTime = 30;
+        second.summaryResult.sampleCount = 2;
+        second.summaryResult.threadCount = 1;
+        second.summaryResult.processCount = 1;
+        second.summaryResult.lostChunks = 1;
+        second.summaryResult.command = QStringLiteral("perf record ./server");
+
+        first.merge(second);
+
+        // the process frames of the same pid stay apart, the other frames are shared
+        QCOMPARE(first.frameTable.frameCount(), 4);
+        QCOMPARE(first.stackTable.size(), 4);
+        QCOMPARE(first.stackTable.frameId(2, 0), fooFrame);
+        QCOMPARE(first.stackTable.frameId(2, 1), mainFrame);
+        QCOMPARE(first.stackTable.frameId(3, 0), mainFrame);
+        const auto mergedProcess = first.stackTable.processFrameId(3);
+        QVERIFY(mergedProcess != firstProcess.first);
+        QCOMPARE(first.frameTable.symbol(mergedProcess), QStringLiteral("app (1)"));
+        QCOMPARE(first.frameTable.string(first.frameTable.frame(mergedProcess).file), QStringLiteral("second.data"));
+
+        // the samples of the second input are aligned at the start of the first one
+        const auto samples = first.sampleStore.samples();
+        QCOMPARE(samples.size(), 4);
+        QCOMPARE(samples.at(2).time, quint64(1000));
+        QCOMPARE(samples.at(2).stack, 2);
+        QCOMPARE(samples.at(3).time, quint64(1020));
+        QCOMPARE(samples.at(3).stack, 3);
+        QCOMPARE(first.threadTable.size(), 2);
+        QCOMPARE(first.threadTable.stackCounts(1).at(0).stack, 2);
+
+        const auto& summary = first.summaryResult;
+        QCOMPARE(summary.applicationStartTime, quint64(1000));
+        QCOMPARE(summary.applicationRunningTime, quint64(30));
+        QCOMPARE(summary.sampleCount, quint64(4));
+        QCOMPARE(summary.processCount, quint32(2));
+        QCOMPARE(summary.lostChunks, quint64(2));
+        QCOMPARE(summary.lostIntervals.size(), 1);
+        QCOMPARE(summary.lostIntervals.at(0).startTime, quint64(1002));
+        QCOMPARE(summary.lostIntervals.at(0).endTime, quint64(1010));
+        QCOMPARE(summary.command, QStringLiteral("perf record ./app\nperf record ./server"));
+    }
+
+    void testBinaryCosts()
+    {
+        SummaryData summary;
+        summary.addBinaryCosts({{QStringLiteral("libc.so"), 2, 5}, {QStringLiteral("app"), 1, 10}});
+        QCOMPARE(summary.binaryCosts.size(), 2);
+        QCOMPARE(summary.binaryCosts.at(0).binary, QStringLiteral("app"));
+
+        summary.addBinaryCosts({{QStringLiteral("libc.so"), 4, 6}, {QStringLiteral("[kernel]"), 3, 3}});
+        QCOMPARE(summary.binaryCosts.size(), 3);
+        QCOMPARE(summary.binaryCosts.at(0).binary, QStringLiteral("libc.so"));
+        QCOMPARE(summary.binaryCosts.at(0).selfCost, quint64(6));
+        QCOMPARE(summary.binaryCosts.at(0).inclusiveCost, quint64(11));
+        QCOMPARE(summary.binaryCosts.at(2).binary, QStringLiteral("[kernel]"));
+    }
+
+    void testProfile()
+    {
+        FrameTable frames;
+        const auto tree = generateTree(2, 2, &frames);
+        SummaryData summary;
+        summary.sampleCount = 42;
+
+        const auto withSummary = Profile().withSummary(frames, summary);
+        const auto withBottomUp = withSummary.withBottomUp(tree);
+        QCOMPARE(withBottomUp.summary().sampleCount, quint64(42));
+        QCOMPARE(withBottomUp.frames().frameCount(), frames.frameCount());
+        QCOMPARE(withBottomUp.bottomUp().size(), tree.size());
+
+        // published profiles never change
+        QCOMPARE(withSummary.bottomUp().size(), 1);
+        QCOMPARE(withBottomUp.topDown().size(), 1);
     }
 };
 